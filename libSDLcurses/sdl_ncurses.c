@@ -28,32 +28,58 @@ USA
 #include <stdlib.h>
 #include <stdarg.h>
 #include <assert.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SDL_CURSES_POSIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <termios.h>
+#include <poll.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include "sdl_ncurses.h"
+#include "sdl_ncurses_font.h"
 
 
 
 /*
  * globals
  */
-SDL_Surface *screen;
-TTF_Font *g_term_font;
-WINDOW *stdscr = NULL;
-WINDOW *curscr = NULL;
-bool echo_on = TRUE;
-bool cbreak_on = FALSE;
-int pop_index = 0;
-int push_index = 0;
-char inbuffer[MAX_INPUT_PENDING];
-unsigned int screen_width;
-unsigned int screen_height;
-unsigned int display_char_height;
-unsigned int display_char_width;
+
+/* the exported globals are per thread, each thread's being those of
+ * the screen it has current; see set_term */
+SDL_CURSES_TLS SDL_Surface *screen;	/* what cells are drawn on */
+SDL_CURSES_TLS TTF_Font *g_term_font;	/* NULL when drawing with the built-in font */
+SDL_CURSES_TLS WINDOW *stdscr = NULL;
+SDL_CURSES_TLS WINDOW *curscr = NULL;
+SDL_CURSES_TLS bool echo_on = TRUE;
+SDL_CURSES_TLS bool cbreak_on = FALSE;
+SDL_CURSES_TLS int halfdelay_tenths = 0;
+SDL_CURSES_TLS unsigned int screen_width;
+SDL_CURSES_TLS unsigned int screen_height;
+SDL_CURSES_TLS unsigned int display_char_height;
+SDL_CURSES_TLS unsigned int display_char_width;
 
  
-unsigned short LINES = SCREEN_CHAR_HEIGHT;
-unsigned short COLS = SCREEN_CHAR_WIDTH;
+SDL_CURSES_TLS unsigned short LINES = SCREEN_CHAR_HEIGHT;
+SDL_CURSES_TLS unsigned short COLS = SCREEN_CHAR_WIDTH;
 
-SDL_Color color_pots[ COLORS ] = {
+static const SDL_Color default_pots[ COLORS ] = {
    {0, 0, 0, 0},    // black 0 
    {128, 0, 0, 0},    // red 1
    {0, 128, 0, 0},    // green 2
@@ -72,1074 +98,8211 @@ SDL_Color color_pots[ COLORS ] = {
    {255, 255, 255, 0} // bright white 15
 };
 
-short color_pairs[COLOR_PAIRS * 2];
+SDL_CURSES_TLS SDL_Color color_pots[ COLORS ];
+SDL_CURSES_TLS short color_pairs[COLOR_PAIRS * 2];
+
+/* settings for the screens newterm makes; font_file is usefont's copy */
+static char *font_file = NULL;
+static int font_points = 12;
+static int scale_request = 1;
+static bool terminal_request = FALSE;
+
+/* the alternate character set: the characters drawn as line graphics
+ * map to themselves with A_ALTCHARSET, a few others to the nearest
+ * plain character.  It is the same for every screen. */
+#define ACS_DRAWN(c) [ c ] = (c) | A_ALTCHARSET
+
+const chtype acs_map[128] = {
+   ACS_DRAWN( 'l' ), ACS_DRAWN( 'm' ), ACS_DRAWN( 'k' ), ACS_DRAWN( 'j' ),
+   ACS_DRAWN( 't' ), ACS_DRAWN( 'u' ), ACS_DRAWN( 'v' ), ACS_DRAWN( 'w' ),
+   ACS_DRAWN( 'q' ), ACS_DRAWN( 'x' ), ACS_DRAWN( 'n' ), ACS_DRAWN( 'o' ),
+   ACS_DRAWN( 'p' ), ACS_DRAWN( 'r' ), ACS_DRAWN( 's' ), ACS_DRAWN( '0' ),
+   ACS_DRAWN( 'a' ), ACS_DRAWN( 'h' ), ACS_DRAWN( '~' ), ACS_DRAWN( '`' ),
+   [ 'f' ] = '\'', [ 'g' ] = '#', [ ',' ] = '<', [ '+' ] = '>',
+   [ '.' ] = 'v', [ '-' ] = '^', [ 'i' ] = '#', [ 'y' ] = '<',
+   [ 'z' ] = '>', [ '{' ] = '*', [ '|' ] = '!', [ '}' ] = 'f'
+};
 
 
-/***********************************
- *** Window Manipulation Routines ***
- ***********************************/
+/*
+ * screens
+ */
 
 /*
-  Calling newwin creates and returns a pointer to a new window
-  with the given number of lines and columns.  The upper
-  left-hand corner of the window is at line begin_y, column
-  begin_x.  If either nlines or ncols is zero, they default to
-  LINES - begin_y and COLS - begin_x.  A new full-screen window
-  is created by calling newwin(0,0,0,0).  * Create a new window
-  of the given dimensions at a given position
+  Keyboard input is kept in a ring of key events.  Each entry holds
+  the full key code as wgetch returns it (function keys are SDLK_*
+  values above 255), the modifier state and the SDL tick count when
+  the key arrived.  In nocbreak mode keys are queued as they are typed
+  and only become readable, key_ready entries at a time, once their
+  line is complete; ungetch pushes keys back onto the front.
 */
-
-WINDOW *newwin( int height, int  width, int ypos, int xpos )
+typedef struct s_KeyEvent
 {
-   WINDOW * newwinptr;
+   int code;
+   bool fkey;		/* code is a KEY_ value, not a character */
+   SDLMod mod;
+   Uint32 ticks;
+} KEY_EVENT;
+
+/* a cached glyph; see the glyph cache below */
+#define GLYPH_ACS     (1)
+#define GLYPH_BOLD    (2)
+#define GLYPH_STYLES  (16)
+#define GLYPH_BUCKETS (2048)
+#define GLYPH_LIMIT   (1024)
+
+typedef struct s_Glyph
+{
+      Uint32 key;		/* character << 4 | style */
+      Uint8 *mask;
+      struct s_Glyph *chain;	/* next in the hash bucket */
+      struct s_Glyph *newer;	/* least recently used list */
+      struct s_Glyph *older;
+} GLYPH;
+
+/* a drawing command queued by another thread; see the drawing
+ * command queue below */
+typedef struct s_DrawCmd
+{
+      struct s_DrawCmd *volatile next;	/* the next newer command */
+      WINDOW *win;
+      int op;			/* DRAW_ADDSTR, ... */
+      int y, x, n;
+      attr_t attrs;
+      short color;
+      char text[1];		/* DRAW_ADDSTR's string, n bytes */
+} DRAW_CMD;
+
+/* the pixels of a window's cells, see the backing store below */
+typedef struct s_Backing
+{
+      SDL_Surface *surface;	/* NULL until drawn, or once evicted */
+      Uint32 shown;		/* SP->backing_clock when last refreshed */
+      int *first;		/* per row, the cells changed since they */
+      int *last;		/* were last drawn on surface, as firstch */
+} BACKING;
+
+/* a row of a compressed window as runs of like cells; see the
+ * compressed rows below */
+typedef struct s_Run
+{
+      wchar_t wc;
+      attr_t attr;
+      int len;			/* cells */
+} RUN;
 
-   /* allocate buffer to hold window */
-   newwinptr = malloc( sizeof( WINDOW ) );
+typedef struct s_Runs
+{
+      int count;
+      RUN run[1];		/* count of them, covering the row */
+} RUNS;
+
+/* a block of a screen's window pool; see the window pool below */
+typedef struct s_PoolBlock POOL_BLOCK;
+#define POOL_CLASSES (19)	/* 64 bytes to 16M */
+
+/* Everything that belongs to one terminal.  newterm makes a screen
+ * current for the calling thread and set_term switches between them;
+ * the routines below all work on the calling thread's screen, SP.
+ * The exported globals are copies of its fields: set_term saves them
+ * into the screen it leaves and loads them from the one it enters.
+ * A screen must only be used by one thread at a time, but different
+ * threads may each draw on a screen of their own at once.  Only one
+ * screen has the display and the keyboard; the rest draw on surfaces
+ * of their own, which term_surface hands out.  What is not in a
+ * screen is process-wide: the settings for the screens newterm makes,
+ * the keyboard's state, which goes with the display, and the list of
+ * terminals to put back at exit.  newterm and delscreen change these,
+ * so screens are made and deleted by one thread at a time. */
+struct s_Screen
+{
+      /* the exported globals, while another screen is current */
+      SDL_Surface *screen;
+      TTF_Font *font;
+      WINDOW *stdscr;
+      WINDOW *curscr;
+      bool echo_on;
+      bool cbreak_on;
+      int halfdelay_tenths;
+      unsigned int screen_width;
+      unsigned int screen_height;
+      unsigned int char_height;
+      unsigned int char_width;
+      unsigned short lines;
+      unsigned short cols;
+      SDL_Color color_pots[ COLORS ];
+      short color_pairs[ COLOR_PAIRS * 2 ];
+
+      bool display;		/* has the display and keyboard */
+      struct s_Tty *tty;	/* the terminal it is on instead, if it is */
+      SDL_Surface *video;	/* the display: screen, or screen scaled up */
+      int scale_factor;
+
+      /* rectangles handed to SDL_UpdateRects by wrefresh, one per dirty row */
+      SDL_Rect *update_rects;
+      int update_rects_size;
+
+      /* keyboard input queue */
+      KEY_EVENT key_queue[ MAX_INPUT_PENDING ];
+      int key_head;		/* index of the oldest key */
+      int key_count;		/* keys queued */
+      int key_ready;		/* keys from the head that may be read */
+      int typeahead_fd;
+
+      /* blinking */
+      WINDOW *windows;		/* every window, newest first */
+      int blink_rows;		/* flagged rows in all windows */
+      bool blink_visible;	/* phase: blinking text shown */
+      volatile bool blink_due;
+      SDL_TimerID blink_timer;
+      WINDOW **owners;		/* the window each cell was last drawn from */
+      int owner_lines, owner_cols;
+
+      /* glyph cache */
+      Uint8 *glyph_ascii[ GLYPH_STYLES ][ 128 ];
+      GLYPH *glyph_buckets[ GLYPH_BUCKETS ];
+      GLYPH *glyph_newest;
+      GLYPH *glyph_oldest;
+      int glyph_count;
+      int glyph_limit;
+      void *atlas_map;		/* the mapped cache file, if any */
+      size_t atlas_map_size;
+      int underline_row;	/* the row of a cell the underline is drawn on */
+      bool ttf_init;		/* TTF_Init was called for the font */
+
+      /* cursor */
+      int cursor_visibility;	/* 0 invisible, 1 normal, 2 block */
+      bool cursor_drawn;
+      int cursor_col;		/* screen cell the cursor is in */
+      int cursor_row;
+      Uint8 *cursor_save;
+
+      /* drawing commands from other threads */
+      DRAW_CMD *volatile queue_head;	/* the newest, producers push here */
+      DRAW_CMD *queue_tail;		/* the oldest, wrefresh pops here */
+      DRAW_CMD queue_stub;
+      DRAW_CMD *held, *held_last;	/* taken off the queue, not yet applied */
+
+      /* window pool */
+      POOL_BLOCK *pool_free[ POOL_CLASSES ];	/* free blocks by size class */
+      int pool_kept[ POOL_CLASSES ];		/* how many are on each list */
+      unsigned long pool_bytes;		/* held by the pool, free or not */
+      int live_windows;
+
+      /* backing stores */
+      unsigned long backing_bytes;	/* the pixels of all of them */
+      unsigned long backing_limit;
+      Uint32 backing_clock;		/* counts refreshes of windows with one */
+
+      /* compressed rows */
+      bool pack_new;			/* newwin makes compressed windows */
+      bool pack_due;			/* rows were expanded since the last packing */
+
+      /* frame recording */
+      FILE *record;			/* the stream, NULL if not recording */
+      Uint32 record_start;		/* SDL_GetTicks() when it began */
+      bool record_frame;		/* a frame is being written */
+
+      /* PNG snapshots */
+      struct s_PngJob *png_job;		/* the last one, written or not */
+      SDL_Thread *png_thread;		/* writing it, NULL once waited for */
+
+      struct s_Mirror *mirror;		/* see shmmirror */
+      struct s_Stream *stream;		/* see streamcells */
+};
 
-   if ( newwinptr == NULL ) {
-      return ( NULL );
-   }
+static SDL_CURSES_TLS SCREEN *SP = NULL;	/* the calling thread's screen */
+static SCREEN *display_screen = NULL;		/* the one with the display */
 
-   /* set up data members of window */
-   newwinptr->x = xpos;
-   newwinptr->y = ypos;
-   newwinptr->cx = 0;
-   newwinptr->cy = 0;
-   newwinptr->width = width;
-   newwinptr->height = height;
-   newwinptr->delay = TRUE;
-   newwinptr->keypad_on = FALSE;
 
-   /* allocate buffer to hold window text */
-   newwinptr->text = malloc( width * height * sizeof(char) );
-   if (newwinptr->text == NULL) {
-      return NULL;
-   }
-   memset( newwinptr->text, 32, width * height * sizeof(char)  );
+/*
+ * keyboard input queue
+ */
 
-   /* allocate buffer to hold window attribures */
-   newwinptr->attrib = malloc( width * height * sizeof(attr_t) );
-   if (newwinptr->attrib == NULL)
-   {
-      free( newwinptr->text );
-      return NULL;
-   }	
-   memset( newwinptr->attrib, 0, width * height * sizeof(attr_t) );
-   newwinptr->attributes = 0;
-   return newwinptr;
+/* auto-repeat: SDL 1.2 does not mark repeated key presses, so a press
+ * of a key that has not been released yet is taken to be a repeat.
+ * There is one keyboard, the display's, so this state is not kept per
+ * screen; flushinp clears key_held when a screen gets the display. */
+static int key_repeat_delay = 100;
+static int key_repeat_interval = 10;
+static bool key_coalesce = FALSE;
+static unsigned long key_repeats_dropped = 0;
+static bool key_held[ SDLK_LAST ];
+
+static bool key_push(const KEY_EVENT *key)
+{
+   if (SP->key_count == MAX_INPUT_PENDING)
+      return FALSE;
+   SP->key_queue[ (SP->key_head + SP->key_count) % MAX_INPUT_PENDING ] = *key;
+   SP->key_count++;
+   return TRUE;
 }
 
-/**
-   initscr is normally the first curses routine to call when
-   initializing a program.  A few special routines sometimes need
-   to be called before it; these are slk_init, filter, ripoffline,
-   use_env. We do not implement these ;-)
-
-*/
-WINDOW *initscr(void)
+static bool key_push_front(const KEY_EVENT *key)
 {
+   if (SP->key_count == MAX_INPUT_PENDING)
+      return FALSE;
+   SP->key_head = (SP->key_head + MAX_INPUT_PENDING - 1) % MAX_INPUT_PENDING;
+   SP->key_queue[ SP->key_head ] = *key;
+   SP->key_count++;
+   SP->key_ready++;
+   return TRUE;
+}
 
-   int minx, maxx;
-   int miny, maxy;
-   int advance;
-   int x,y;
-
-   SDL_Init( SDL_INIT_VIDEO );
-   SDL_EnableKeyRepeat( 100, 10 );
-   SDL_EnableUNICODE(1);
-   TTF_Init();
+static void key_pop(KEY_EVENT *key)
+{
+   *key = SP->key_queue[ SP->key_head ];
+   SP->key_head = (SP->key_head + 1) % MAX_INPUT_PENDING;
+   SP->key_count--;
+   if (SP->key_ready > 0)
+      SP->key_ready--;
+}
 
-   /* man is the measure of all things, and this is a monospace font,
-    * so we dimension around '@' */
-   g_term_font = TTF_OpenFont( "ASCII.fon", 12 );
-   /* if this fires, you are probably missing a font file */
-   assert( g_term_font != NULL );
+/* drop the most recently queued key of an incomplete line */
+static bool key_unpush(void)
+{
+   if (SP->key_count == SP->key_ready)
+      return FALSE;
+   SP->key_count--;
+   return TRUE;
+}
 
-   TTF_SizeText( g_term_font, "@", &display_char_width, &display_char_height);
+/* are there keys waiting to be read? */
+static bool input_pending(void)
+{
+   SDL_Event event;
 
-   /* work out window size needed */
-   screen_width = SCREEN_CHAR_WIDTH * display_char_width;
-   screen_height = SCREEN_CHAR_HEIGHT * display_char_height;
+   if (SP->key_ready > 0)
+      return TRUE;
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL)
+      return tty_input_pending( SP->tty );
+#endif
+   if (!SP->display)
+      return FALSE;
+   return SDL_PeepEvents( &event, 1, SDL_PEEKEVENT, SDL_KEYDOWNMASK ) > 0;
+}
 
-   /* set it up */
-   screen = SDL_SetVideoMode( screen_width, screen_height, 0, 0 );
-   assert(screen != NULL);
 
-   SDL_WM_SetCaption("Omega", NULL);
+/*
+ * blinking
+ */
 
-   
-   /* ignore events we can't possibly use */
-   SDL_EventState( SDL_IGNORE, SDL_MOUSEMOTION );
-   SDL_EventState( SDL_IGNORE, SDL_JOYBALLMOTION );
-   SDL_EventState( SDL_IGNORE, SDL_JOYHATMOTION );
-   
-   atexit( SDL_Quit );
-   stdscr = newwin(screen_height, screen_width, 0, 0);
-   curscr = stdscr;
-   echo_on = TRUE;
-   cbreak_on = FALSE;
-   pop_index = 0;
-   push_index = 0;
-   memset(inbuffer, 0, MAX_INPUT_PENDING * sizeof(char));
+/* Rows that may hold A_BLINK cells are flagged as the cells are
+ * written.  While any row anywhere is flagged, a timer flips the blink
+ * phase every BLINK_INTERVAL ms; the flagged rows are then scanned and
+ * only their blinking cells redrawn.  A row found to have no blinking
+ * cells left is unflagged, and the timer stops when none remain. */
+#define BLINK_INTERVAL (500)
+#define BLINK_EVENT (1)		/* SDL_USEREVENT code the timer posts */
+
+/* runs in SDL's timer thread, so it only posts an event to wake the
+ * input loop; the drawing happens in blink_update.  param is the
+ * screen to blink; one without the display blinks at its next
+ * refresh, as there is no input loop to wake. */
+static Uint32 blink_callback(Uint32 interval, void *param)
+{
+   SCREEN *sp = param;
+   SDL_Event event;
 
-   return stdscr;
+   if (!sp->blink_due) {
+      sp->blink_due = TRUE;
+      if (!sp->display)
+	 return interval;
+      event.type = SDL_USEREVENT;
+      event.user.code = BLINK_EVENT;
+      event.user.data1 = NULL;
+      event.user.data2 = NULL;
+      SDL_PushEvent( &event );
+   }
+   return interval;
 }
 
-/*
-  Calling delwin deletes the named window, freeing all memory
-  associated with it (it does not actually erase the window's
-  screen image).  Subwindows must be deleted before the main
-  window can be deleted.
-*/
-
-int delwin(WINDOW *win)
+static void set_blink_row(WINDOW *win, int y, bool on)
 {
-   if (win == NULL)
-      return ERR;
-   free( win->attrib );
-   win->attrib = NULL;
-   free( win->text );
-   win->text = NULL;
-   free( win );
-   return OK;
+   if (win->blinkrows[y] == on)
+      return;
+   win->blinkrows[y] = on;
+   SP->blink_rows += on ? 1 : -1;
+   /* a terminal blinks its cells itself */
+   if (on && (SP->blink_timer == NULL) && (SP->tty == NULL))
+      SP->blink_timer = SDL_AddTimer( BLINK_INTERVAL, blink_callback, SP );
 }
 
-/*
-  A program should always call endwin before exiting or escaping
-  from curses mode temporarily.  This routine restores tty modes,
-  moves the cursor to the lower left-hand corner of the screen
-  and resets the terminal into the proper non-visual mode.
-  Calling refresh or doupdate after a temporary escape causes the
-  program to resume visual mode.
-*/
+static void mark_blink(WINDOW *win, int y, attr_t attrs)
+{
+   if (BLINK( attrs ))
+      set_blink_row( win, y, TRUE );
+}
 
-int endwin(void)
+static void clear_blink_rows(WINDOW *win)
 {
-   /* we don't have any sensible way of doing this, so it always fails */
-   return ERR;
+   int row;
+
+   for (row = 0; row < win->height; row++)
+      set_blink_row( win, row, FALSE );
 }
 
-/*
-  Calling mvwin moves the window so that the upper left-hand
-  corner is at position (x, y).  If the move would cause the
-  window to be off the screen, it is an error and the window is
-  not moved.  Moving subwindows is allowed, but should be
-  avoided.
-*/
-int mvwin(WINDOW *win, int y, int x)
+/* the window each screen cell was last drawn from, as big as the
+ * screen, so that blinking redraws only cells a window still shows;
+ * NULL if there is too little memory */
+static WINDOW **screen_owners(void)
 {
-   win->x = x;
-   win->y = y;
-   return OK;
+   WINDOW **owners;
+   int y, cols;
+
+   if ((SP->owners != NULL) && (SP->owner_lines == LINES) && (SP->owner_cols == COLS))
+      return SP->owners;
+   owners = calloc( (size_t) LINES * COLS, sizeof(WINDOW *) );
+   if ((owners != NULL) && (SP->owners != NULL)) {
+      cols = (COLS < SP->owner_cols) ? COLS : SP->owner_cols;
+      for (y = 0; (y < LINES) && (y < SP->owner_lines); y++)
+	 memcpy( owners + y * COLS, SP->owners + y * SP->owner_cols, cols * sizeof(WINDOW *) );
+   }
+   free( SP->owners );
+   SP->owners = owners;
+   SP->owner_lines = LINES;
+   SP->owner_cols = COLS;
+   return owners;
 }
 
-/*
-  The refresh and wrefresh routines (or wnoutrefresh and
-  doupdate) must be called to get actual output to the terminal,
-  as other routines merely manipulate data structures.  The
-  routine wrefresh copies the named window to the physical
-  terminal screen, taking into account what is already there to
-  do optimizations.  The refresh routine is the same, using
-  stdscr as the default window.  Unless leaveok has been enabled,
-  the physical cursor of the terminal is left at the location of
-  the cursor for that window.
-*/
-int wrefresh( WINDOW *win )
+/* columns x0..xend - 1 of row y of win have been drawn on the screen */
+static void claim_cells(WINDOW *win, int y, int x0, int xend)
 {
-   // actually draw
-   int xat, yat;
-   int xscreen, yscreen;
-   char string[ 1024 ];
+   WINDOW **owners = screen_owners();
+   int row = win->y + y;
+   int x;
+
+   if ((owners == NULL) || (row < 0) || (row >= LINES))
+      return;
+   for (x = x0; x < xend; x++)
+      if ((win->x + x >= 0) && (win->x + x < COLS))
+	 owners[ row * COLS + win->x + x ] = win;
+}
 
-   SDL_Color fg;
-   SDL_Color bg;
-   SDL_Rect rect;
-   SDL_Surface *temp;
-   attr_t last_attrib;
-   attr_t attrib;
-   int style;
-   int string_index;
-   int w,h;
+/* whether row y, column x of win is what the screen shows there */
+static bool owns_cell(WINDOW *win, int y, int x)
+{
+   WINDOW **owners = screen_owners();
+   int row = win->y + y;
+   int col = win->x + x;
 
-   /* if COLS > 1023 then there is the possibility of overflow */
-   assert(COLS <= 1023 );
+   if ((row < 0) || (row >= LINES) || (col < 0) || (col >= COLS))
+      return FALSE;
+   return (owners == NULL) || (owners[ row * COLS + col ] == win);
+}
 
+/* win is going: the cells it was drawn in have no window */
+static void disown_cells(WINDOW *win)
+{
+   int i;
 
-   for ( yat = 0; yat < win->height; yat++ ) {
+   if (SP->owners == NULL)
+      return;
+   for (i = 0; i < SP->owner_lines * SP->owner_cols; i++)
+      if (SP->owners[i] == win)
+	 SP->owners[i] = NULL;
+}
 
-      yscreen = ( yat + win->y ) * display_char_height;
-      rect.x = win->x * display_char_width;
-      rect.y = yscreen;
-      rect.w = 0;
-      rect.h = display_char_height;
-      xat = 0;
+/*
+ * drawing command queue
+ */
 
+/* Threads other than a screen's own may not draw on it, but they may
+ * queue drawing commands for its windows with the qw routines.  The
+ * commands are applied in the order they were queued by the next
+ * wrefresh in the screen's thread, so producers never wait on it or
+ * on the drawing.  The queue is an intrusive multiple producer,
+ * single consumer list: a producer swaps its command in as the
+ * newest with one atomic exchange and then links the old newest to
+ * it; the consumer takes from the oldest end and never needs a lock.
+ * A stub command keeps the list from ever being empty. */
+#define DRAW_ADDSTR  (0)
+#define DRAW_ATTRON  (1)
+#define DRAW_ATTROFF (2)
+#define DRAW_ATTRSET (3)
+#define DRAW_MOVE    (4)
+#define DRAW_CHGAT   (5)
+
+#if defined(__GNUC__)
+#define QUEUE_XCHG(p, v) __atomic_exchange_n( (p), (v), __ATOMIC_ACQ_REL )
+#define QUEUE_LOAD(p) __atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define QUEUE_STORE(p, v) __atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+#elif defined(_MSC_VER)
+/* volatile accesses are ordered as acquire and release here */
+#define QUEUE_XCHG(p, v) ((DRAW_CMD *) _InterlockedExchangePointer( (void *volatile *) (p), (v) ))
+#define QUEUE_LOAD(p) (*(p))
+#define QUEUE_STORE(p, v) (*(p) = (v))
+#endif
+
+#ifdef QUEUE_XCHG
+
+static void queue_push(SCREEN *sp, DRAW_CMD *cmd)
+{
+   DRAW_CMD *previous;
 
-      while ( xat < win->width ) {
+   cmd->next = NULL;
+   previous = QUEUE_XCHG( &sp->queue_head, cmd );
+   QUEUE_STORE( &previous->next, cmd );
+}
 
-	 string_index = 0;
-	 memset(string, 0, 1024);
+/* the oldest command, NULL if there is none, or if the only one left
+ * is still being linked in by its producer; it is then taken next
+ * time */
+static DRAW_CMD *queue_pop(SCREEN *sp)
+{
+   DRAW_CMD *tail = sp->queue_tail;
+   DRAW_CMD *next = QUEUE_LOAD( &tail->next );
+
+   if (tail == &sp->queue_stub) {
+      if (next == NULL)
+	 return NULL;
+      sp->queue_tail = next;
+      tail = next;
+      next = QUEUE_LOAD( &next->next );
+   }
+   if (next != NULL) {
+      sp->queue_tail = next;
+      return tail;
+   }
+   if (tail != QUEUE_LOAD( &sp->queue_head ))
+      return NULL;
+   /* tail is the last one: put the stub behind it so it can go */
+   queue_push( sp, &sp->queue_stub );
+   next = QUEUE_LOAD( &tail->next );
+   if (next == NULL)
+      return NULL;
+   sp->queue_tail = next;
+   return tail;
+}
 
+#else
 
-	 do {
-	    string[ string_index ] = *( win->text + xat + ( yat * win->width ) );
-	    last_attrib =  *( win->attrib + xat + ( yat * win->width ) ); 
-	    rect.w += display_char_width;
-	    string_index++;
-	    xat++;
-	 } while (( xat < win->width ) && 
-		  ( last_attrib == *( win->attrib + xat + ( yat * win->width ) ) )); 
+/* no atomic exchange: the qw routines fail */
+static void queue_push(SCREEN *sp, DRAW_CMD *cmd)
+{
+}
 
-/*	 string[ string_index ] = *( win->text + xat + ( yat * win->width ) );
-	 last_attrib =  *( win->attrib + xat + ( yat * win->width ) ); 
-	 rect.w = display_char_width;
-*/
-	 /* if our attributes change, or we get to the end of the line, render what we have */
-	 if (!REVERSE( last_attrib )) { 
-	 
-	    
-	    fg = color_pots[ FG( PAIR_NUMBER( last_attrib ) ) ];
-	    bg = color_pots[ BG( PAIR_NUMBER( last_attrib ) ) ]; 
-	    
-	 } else {
-	    
-	    bg = color_pots[ FG( PAIR_NUMBER( last_attrib ) ) ];
-	    fg = color_pots[ BG( PAIR_NUMBER( last_attrib ) ) ]; 
-	 }
-	 
-	 
-	 if (DIM(last_attrib)) {
-	    fg.r = fg.r >> 1;	 fg.b = fg.b >> 1;	 fg.g = fg.g >> 1;
-	    bg.r = bg.r >> 1;	 bg.b = bg.b >> 1;	 bg.g = bg.g >> 1;
-	 }
-	 
-	 if (STANDOUT(last_attrib)) {
-	    fg.r = fg.r << 1;	    fg.b = fg.b << 1;	    fg.g = fg.g << 1;
-	    bg.r = bg.r << 1;	    bg.b = bg.b << 1;       bg.g = bg.g << 1;
-	 }
-	 
-	 if (BOLD(last_attrib)) {
-	    fg.r = (fg.r << 1) | 15;	    fg.b = (fg.b << 1) | 15;	    fg.g = (fg.g << 1) | 15;
-	 }
+static DRAW_CMD *queue_pop(SCREEN *sp)
+{
+   return NULL;
+}
 
-	 style = TTF_STYLE_NORMAL;
-	 style |= UNDERLINE(last_attrib) ? TTF_STYLE_UNDERLINE : 0;
-	 TTF_SetFontStyle( g_term_font, TTF_STYLE_NORMAL );
-	 
+#endif /* QUEUE_XCHG */
 
-/*	 if ((string[0] != '\0') && (string[0] != ' '))
-	 fprintf(stderr,"%c %x %x\t", string[0], string[0], PAIR_NUMBER( last_attrib ));*/
+/* a zeroed command for win with room for n bytes of text, to be
+ * filled in and pushed; NULL if it cannot be queued */
+static DRAW_CMD *new_command(SCREEN *sp, WINDOW *win, int op, int n)
+{
+   DRAW_CMD *cmd;
 
-	 temp = TTF_RenderText_Shaded( g_term_font, string, fg, bg );
-	 if (temp == NULL)
-	 {
-	    return ERR;
-	 }
+#ifdef QUEUE_XCHG
+   if ((sp == NULL) || (win == NULL))
+      return NULL;
+   cmd = calloc( 1, sizeof(DRAW_CMD) + n );
+   if (cmd == NULL)
+      return NULL;
+   cmd->win = win;
+   cmd->op = op;
+   return cmd;
+#else
+   return NULL;
+#endif
+}
 
-	 SDL_BlitSurface( temp, NULL, screen, &rect );
-	 SDL_FreeSurface( temp );
-	 
-	 rect.x += rect.w; /* display_char_width; */
-	 rect.w = 0;
-	 /* xat++; */
+/* move the current screen's queued commands to the end of its held
+ * list, which keeps their order, then drop the held ones for win */
+static void hold_queue(WINDOW *win)
+{
+   DRAW_CMD *cmd;
+   DRAW_CMD *volatile *link;
+
+   while ((cmd = queue_pop( SP )) != NULL) {
+      cmd->next = NULL;
+      if (SP->held == NULL)
+	 SP->held = cmd;
+      else
+	 SP->held_last->next = cmd;
+      SP->held_last = cmd;
+   }
+   if (win == NULL)
+      return;
+   SP->held_last = NULL;
+   for (link = &SP->held; (cmd = *link) != NULL; ) {
+      if (cmd->win == win) {
+	 *link = cmd->next;
+	 free( cmd );
+      } else {
+	 SP->held_last = cmd;
+	 link = &cmd->next;
       }
    }
-
-
-   SDL_UpdateRect(screen, 0, 0, 0, 0); 
-   return OK;
 }
 
-int wmove( WINDOW *win, int y, int x )
+/* apply the current screen's queued commands, oldest first */
+static void run_queue(void)
 {
-   if ((x < 0) || (y < 0) || (y >= win->width) || (x >= win->width))
-      return ERR;
-   win->cx = x;
-   win->cy = y;
-   return OK;
+   DRAW_CMD *cmd;
+
+   hold_queue( NULL );
+   while ((cmd = SP->held) != NULL) {
+      SP->held = cmd->next;
+      switch (cmd->op) {
+	 case DRAW_ADDSTR:
+	    waddnstr( cmd->win, cmd->text, cmd->n );
+	    break;
+	 case DRAW_ATTRON:
+	    wattron( cmd->win, cmd->attrs );
+	    break;
+	 case DRAW_ATTROFF:
+	    wattroff( cmd->win, cmd->attrs );
+	    break;
+	 case DRAW_ATTRSET:
+	    wattrset( cmd->win, cmd->attrs );
+	    break;
+	 case DRAW_MOVE:
+	    wmove( cmd->win, cmd->y, cmd->x );
+	    break;
+	 case DRAW_CHGAT:
+	    wchgat( cmd->win, cmd->n, cmd->attrs, cmd->color, NULL );
+	    break;
+      }
+      free( cmd );
+   }
 }
 
 /*
-  The addch, waddch, mvaddch and mvwaddch routines put the
-  character ch into the given window at its current window
-  position, which is then advanced.  They are analogous to
-  putchar in stdio(3).  If the advance is at the right margin,
-  the cursor automatically wraps to the beginning of the next
-  line.  At the bottom of the current scrolling region, if
-  scrollok is enabled, the scrolling region is scrolled up one
-  line.
+  The qw routines queue the like-named drawing routine to be applied
+  to win, a window of sp, by the next wrefresh in the thread that owns
+  sp.  They may be called from any thread, and only fail if memory
+  runs out or the compiler offers no atomic exchange.  win must not be
+  deleted while commands for it may still be queued; delwin drops
+  those queued for it by then and keeps the rest for wrefresh.
+*/
+int qwaddnstr(SCREEN *sp, WINDOW *win, const char *str, int n)
+{
+   DRAW_CMD *cmd;
+   int len;
 
-  If ch is a tab, newline, or backspace, the cursor is moved
-  appropriately within the window.  Backspace moves the cursor
-  one character left; at the left edge of a window it does
-  nothing.  Newline does a clrtoeol, then moves the cursor to the
-  window left margin on the next line, scrolling the window if on
-  the last line.  Tabs are considered to be at every eighth
-  column.  The tab interval may be altered by setting the TABSIZE
-  variable.
+   for (len = 0; ((n < 0) || (len < n)) && (str[len] != '\0'); len++)
+      ;
+   cmd = new_command( sp, win, DRAW_ADDSTR, len );
+   if (cmd == NULL)
+      return ERR;
+   memcpy( cmd->text, str, len );
+   cmd->n = len;
+   queue_push( sp, cmd );
+   return OK;
+}
 
-*/
+int qwaddstr(SCREEN *sp, WINDOW *win, const char *str)
+{
+   return qwaddnstr( sp, win, str, -1 );
+}
 
-int waddch( WINDOW *win, chtype c )
+static int queue_attrs(SCREEN *sp, WINDOW *win, int op, int attrs)
 {
-   attr_t attrs = c & ~0xFF;
+   DRAW_CMD *cmd = new_command( sp, win, op, 0 );
 
-   if ( c == '\t' ) {
-      win->cx += 4 - ( win->cx % 4 );
-   }
+   if (cmd == NULL)
+      return ERR;
+   cmd->attrs = attrs;
+   queue_push( sp, cmd );
+   return OK;
+}
 
-   else {
-      if ( c == '\r' ) {
-	 win->cx = 0;
-      }
+int qwattron(SCREEN *sp, WINDOW *win, int attrs)
+{
+   return queue_attrs( sp, win, DRAW_ATTRON, attrs );
+}
 
-      else {
-	 if ( c == '\n' ) {
-	    win->cx = 0;
-	    win->cy++;
-	 }
+int qwattroff(SCREEN *sp, WINDOW *win, int attrs)
+{
+   return queue_attrs( sp, win, DRAW_ATTROFF, attrs );
+}
 
-	 else {
-	    if ( ( win->cx < win->width ) && ( win->cy < win->height ) ) {
-	       *( win->text + win->cx + win->cy * win->width ) = c;
-	       if (attrs == 0U)
-		  *( win->attrib + win->cx + win->cy * win->width ) = win->attributes;
-	       else
-		  *( win->attrib + win->cx + win->cy * win->width ) = attrs;
-	    }
+int qwattrset(SCREEN *sp, WINDOW *win, int attrs)
+{
+   return queue_attrs( sp, win, DRAW_ATTRSET, attrs );
+}
 
-	    ( win->cx ) ++;
+int qwmove(SCREEN *sp, WINDOW *win, int y, int x)
+{
+   DRAW_CMD *cmd = new_command( sp, win, DRAW_MOVE, 0 );
 
-	 }
-      }
-   }
+   if (cmd == NULL)
+      return ERR;
+   cmd->y = y;
+   cmd->x = x;
+   queue_push( sp, cmd );
    return OK;
 }
 
-int mvwaddch(WINDOW *win, int y, int x, const chtype ch)
+int qwchgat(SCREEN *sp, WINDOW *win, int n, attr_t attr, short color)
 {
-   if (wmove(win,y,x) != OK)
+   DRAW_CMD *cmd = new_command( sp, win, DRAW_CHGAT, 0 );
+
+   if (cmd == NULL)
       return ERR;
-   return waddch(win, ch);
+   cmd->n = n;
+   cmd->attrs = attr;
+   cmd->color = color;
+   queue_push( sp, cmd );
+   return OK;
 }
 
+/*
+ * backing store
+ */
 
-int waddnstr( WINDOW *win, const char *string, int n)
+/* A window may keep a copy of its cells as pixels, its backing
+ * store, on a surface of its own.  Changes to its cells are drawn
+ * into the copy when the window is refreshed, and the rows to be
+ * refreshed are then copied from it to the screen.  A window that
+ * was only touched, because it was moved or uncovered, is therefore
+ * copied rather than drawn glyph by glyph again.  Each store tracks
+ * the cells changed since they were last drawn into it apart from
+ * firstch and lastch, which also count rows that were only touched.
+ * The stores of a screen are kept within SP->backing_limit bytes by
+ * freeing the surfaces of the least recently shown windows; such a
+ * window's copy is drawn whole at its next refresh. */
+#define BACKING_LIMIT (16UL << 20)
+
+/* note that columns x0..x1 of row y differ from the backing store */
+static void backing_touch(BACKING *store, int y, int x0, int x1)
 {
-   const char * stringg;
-   int count;
-
-   if ((string == NULL) || (n == 0))
-      return OK;
+   if ((store->first[y] == _NOCHANGE) || (x0 < store->first[y]))
+      store->first[y] = x0;
+   if ((store->last[y] == _NOCHANGE) || (x1 > store->last[y]))
+      store->last[y] = x1;
+}
 
-   for ( stringg = string, count = 0; 
-	 ((*stringg != '\0') && (count != n)); 
-	 stringg++, count++ ) {
-      if (waddch(win, *stringg) == ERR)
-	 return ERR;
-   }
-   return OK;
+/* free the pixels of a backing store, keeping the store itself */
+static void backing_drop(BACKING *store)
+{
+   if (store->surface == NULL)
+      return;
+   SP->backing_bytes -= store->surface->pitch * store->surface->h;
+   SDL_FreeSurface( store->surface );
+   store->surface = NULL;
 }
 
+/* drop every window's pixels, when they no longer show its cells */
+static void backing_drop_all(void)
+{
+   WINDOW *win;
 
-/*
-  These routines write the characters of the (null-terminated)
-  character string str on the given window.  It is similar to
-  calling wad- dch once for each character in the string.  The
-  four routines with n as the last argument write at most n
-  characters.  If n is -1, then the entire string will be added,
-  up to the maximum number of characters that will fit on the
-  line, or until a terminating null is reached.
-*/
+   if (SP == NULL)
+      return;
+   for (win = SP->windows; win != NULL; win = win->next)
+      if (win->backing != NULL)
+	 backing_drop( win->backing );
+}
 
-int waddstr( WINDOW *win, const char *str)
+/* make the least recently shown window other than win give up its
+ * pixels, FALSE if there is none to take them from */
+static bool backing_evict(WINDOW *win)
 {
-   return waddnstr( win, str, -1 );
+   WINDOW *other;
+   BACKING *oldest = NULL;
+
+   for (other = SP->windows; other != NULL; other = other->next) {
+      if ((other == win) || (other->backing == NULL) || (other->backing->surface == NULL))
+	 continue;
+      if ((oldest == NULL) || ((Sint32) (other->backing->shown - oldest->shown) < 0))
+	 oldest = other->backing;
+   }
+   if (oldest == NULL)
+      return FALSE;
+   backing_drop( oldest );
+   return TRUE;
 }
 
-int mvwaddstr(WINDOW *win, int y, int x, const char *str)
+/*
+  backingstore turns win's backing store on or off; it is off for new
+  windows.  With it on, refreshing rows of win that were touched but
+  not changed, for instance by mvwin or touchwin after a window above
+  it went away, copies their pixels rather than drawing their glyphs
+  again.  backinglimit caps the bytes the current screen's backing
+  stores may take together (16M to begin with); the windows shown
+  least recently lose theirs first, until they are next refreshed.
+*/
+int backingstore(WINDOW *win, bool bf)
 {
-   if (wmove(win, y, x) != OK)
+   BACKING *store = win->backing;
+   int row;
+
+   if (!bf) {
+      if (store != NULL) {
+	 backing_drop( store );
+	 free( store );
+	 win->backing = NULL;
+      }
+      return OK;
+   }
+   if (store != NULL)
+      return OK;
+   /* a screen on a terminal has no pixels */
+   if (SP->tty != NULL)
       return ERR;
-   return waddstr(win, str);
+
+   store = malloc( sizeof(BACKING) + 2 * win->height * sizeof(int) );
+   if (store == NULL)
+      return ERR;
+   store->surface = NULL;
+   store->shown = 0;
+   store->first = (int *) (store + 1);
+   store->last = store->first + win->height;
+   for (row = 0; row < win->height; row++) {
+      store->first[row] = _NOCHANGE;
+      store->last[row] = _NOCHANGE;
+   }
+   win->backing = store;
+   return OK;
 }
-	
-int mvwaddnstr(WINDOW *win, int y, int x, const char *str, int n)
+
+int backinglimit(unsigned long bytes)
 {
-   if (wmove(win, y, x) != OK)
+   if (SP == NULL)
       return ERR;
-   return waddnstr(win, str, n);
+   SP->backing_limit = bytes;
+   while ((SP->backing_bytes > SP->backing_limit) && backing_evict( NULL ))
+      ;
+   return OK;
 }
 
-int vw_printw(WINDOW *win,  const char *fmt, va_list arglist)
+/*
+ * window pool
+ */
+
+/* A window is one block: the WINDOW followed by its row pointers,
+ * cells and change tracking.  The blocks come from a pool kept per
+ * screen, in power of two size classes from 1 << POOL_MIN_SHIFT
+ * bytes up; a freed block goes on its class's free list for the next
+ * window of about its size, so popups that come and go reuse the
+ * same few blocks rather than going back to malloc.  A class keeps
+ * at most POOL_KEEP free blocks, and those beyond are freed, so the
+ * rows packing lets go of do not stay with the screen.  Blocks larger
+ * than the biggest class are malloc'd and freed alone.  wresize
+ * cannot move the WINDOW, so it puts the new arrays in a block of
+ * their own, win->cells.  The rows of compressed windows come from
+ * the pool as well, which is why its classes start small. */
+#define POOL_MIN_SHIFT (6)
+#define POOL_KEEP (16)
+#define POOL_ALIGN(n) (((n) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+struct s_PoolBlock
 {
-   static char buffer[2048];
+      struct s_PoolBlock *next;	/* in its class's free list */
+      size_t size;		/* of the whole block, this header included */
+};
 
-   memset(buffer, 0, 2048 * sizeof(char));
-   vsnprintf(buffer, 2047, fmt, arglist);
-   waddstr(win, buffer);
-   return OK;
+/* the class of a block of size bytes, POOL_CLASSES if too big */
+static int pool_class(size_t size)
+{
+   int class = 0;
+
+   while ((class < POOL_CLASSES) && (((size_t) 1 << (class + POOL_MIN_SHIFT)) < size))
+      class++;
+   return class;
 }
 
-int wprintw(WINDOW *win, const char *fmt, ...)
+static void *pool_alloc(size_t size)
 {
-   va_list params;
-   int result;
+   POOL_BLOCK *block;
+   int class;
+
+   size += sizeof(POOL_BLOCK);
+   class = pool_class( size );
+   if (class < POOL_CLASSES) {
+      block = SP->pool_free[ class ];
+      if (block != NULL) {
+	 SP->pool_free[ class ] = block->next;
+	 SP->pool_kept[ class ]--;
+	 return block + 1;
+      }
+      size = (size_t) 1 << (class + POOL_MIN_SHIFT);
+   }
+   block = malloc( size );
+   if (block == NULL)
+      return NULL;
+   block->size = size;
+   SP->pool_bytes += size;
+   return block + 1;
+}
 
-   va_start(params, fmt);
-   result = vw_printw(win, fmt, params);
-   va_end(params);
-   return result;
+static void pool_free(void *data)
+{
+   POOL_BLOCK *block;
+   int class;
+
+   if (data == NULL)
+      return;
+   block = (POOL_BLOCK *) data - 1;
+   class = pool_class( block->size );
+   if ((class == POOL_CLASSES) || (SP->pool_kept[ class ] >= POOL_KEEP)) {
+      SP->pool_bytes -= block->size;
+      free( block );
+      return;
+   }
+   block->next = SP->pool_free[ class ];
+   SP->pool_free[ class ] = block;
+   SP->pool_kept[ class ]++;
 }
 
-int mvwprintw(WINDOW *win, int y, int x, const char *fmt, ...)
+/* give the free blocks of the current screen's pool back */
+static void pool_release(void)
 {
-   va_list params;
-   int result;
+   POOL_BLOCK *block;
+   int class;
+
+   for (class = 0; class < POOL_CLASSES; class++) {
+      while ((block = SP->pool_free[ class ]) != NULL) {
+	 SP->pool_free[ class ] = block->next;
+	 SP->pool_bytes -= block->size;
+	 free( block );
+      }
+      SP->pool_kept[ class ] = 0;
+   }
+}
 
-   if (wmove(win, y, x) != OK)
-      return ERR;
-   va_start(params, fmt);
-   result = vw_printw(win, fmt, params);
-   va_end(params);
-   return result;
+/*
+ * compressed rows
+ */
 
+/* The rows of a compressed window (see compressrows) are not kept in
+ * arrays of cells.  Each row is either blank, with runs[y], lines[y]
+ * and alines[y] all NULL; packed, with runs[y] holding it as runs of
+ * cells alike in character and attributes; or expanded, with lines[y]
+ * and alines[y] in a pool block of the row's own.  Writing to a row
+ * expands it, reading a cell does not, and the expanded rows are
+ * packed again while the program waits for a key.  A row whose runs
+ * would take more room than its cells is left expanded. */
+
+/* the bytes of an expanded row of a width column window */
+static size_t row_size(int width)
+{
+   return POOL_ALIGN( width * sizeof(wchar_t) ) + width * sizeof(attr_t);
 }
 
-/*
-  The getch, wgetch, mvgetch and mvwgetch, routines read a
-  character from the window.  In no-delay mode, if no input is
-  waiting, the value ERR is returned.  In delay mode, the program
-  waits until the system passes text through to the program.
-  Depending on the setting of cbreak, this is after one
-  character (cbreak mode), or after the first newline (nocbreak
-  mode).  In half-delay mode, the pro- gram waits until a
-  character is typed or the specified timeout has been reached.
-*/
+/* what a blank row is, whatever its width */
+static const RUN blank_run = { ' ', 0, 0 };
 
+/* the run column x of a packed or blank row is in */
+static const RUN *run_at(const RUNS *runs, int x)
+{
+   int i;
 
-int wgetch(WINDOW *win) 
+   if (runs == NULL)
+      return &blank_run;
+   for (i = 0; x >= runs->run[ i ].len; i++)
+      x -= runs->run[ i ].len;
+   return &runs->run[ i ];
+}
+
+/* the character at row y, column x of win, whatever the row's state */
+static wchar_t cell_char(WINDOW *win, int y, int x)
 {
+   if (win->lines[y] != NULL)
+      return win->lines[y][x];
+   return run_at( win->runs[y], x )->wc;
+}
 
-   SDL_Event event;
-   int retchar = ERR;
-   int key_pressed = FALSE;
-   static SDL_keysym last_keysym;
-   
+/* the attributes at row y, column x of win, whatever the row's state */
+static attr_t cell_attrib(WINDOW *win, int y, int x)
+{
+   if (win->alines[y] != NULL)
+      return win->alines[y][x];
+   return run_at( win->runs[y], x )->attr;
+}
 
-   /* fprintf(stderr, "wgetchar  delay %x cbreak %x pop %x push %x \n", win->delay, cbreak_on, pop_index, push_index); */
-   if ((pop_index != push_index) && (cbreak_on == FALSE))
-   {
-      retchar = inbuffer[pop_index];
-      pop_index = ( pop_index + 1 ) % MAX_INPUT_PENDING;
-      key_pressed = TRUE;
+/* make row y of a compressed window blank, freeing what it held */
+static void row_blank(WINDOW *win, int y)
+{
+   pool_free( win->lines[y] );
+   pool_free( win->runs[y] );
+   win->lines[y] = NULL;
+   win->alines[y] = NULL;
+   win->runs[y] = NULL;
+}
+
+/* give row y of win cells that may be written, FALSE if memory ran
+ * out; the rows of windows that are not compressed always have them */
+static bool row_expand(WINDOW *win, int y)
+{
+   RUNS *runs;
+   Uint8 *block;
+   int i, x, n;
+
+   if ((win->runs == NULL) || (win->lines[y] != NULL))
+      return TRUE;
+   block = pool_alloc( row_size( win->width ) );
+   if (block == NULL)
+      return FALSE;
+   win->lines[y] = (wchar_t *) block;
+   win->alines[y] = (attr_t *) (block + POOL_ALIGN( win->width * sizeof(wchar_t) ));
+
+   runs = win->runs[y];
+   if (runs == NULL) {
+      wmemset( win->lines[y], ' ', win->width );
+      memset( win->alines[y], 0, win->width * sizeof(attr_t) );
    } else {
-      pop_index = push_index;
+      for (i = 0, x = 0; i < runs->count; i++) {
+	 wmemset( win->lines[y] + x, runs->run[ i ].wc, runs->run[ i ].len );
+	 for (n = 0; n < runs->run[ i ].len; n++)
+	    win->alines[y][ x++ ] = runs->run[ i ].attr;
+      }
+      pool_free( runs );
+      win->runs[y] = NULL;
    }
+   SP->pack_due = TRUE;
+   return TRUE;
+}
 
+/* turn expanded row y of a compressed window back into runs, if they
+ * take less room than its cells */
+static void row_pack(WINDOW *win, int y)
+{
+   const wchar_t *text = win->lines[y];
+   const attr_t *attrib = win->alines[y];
+   RUNS *runs;
+   size_t size;
+   int count, i, x;
+
+   if (text == NULL)
+      return;
+   for (count = 1, x = 1; x < win->width; x++)
+      if ((text[x] != text[x - 1]) || (attrib[x] != attrib[x - 1]))
+	 count++;
+   if ((count == 1) && (text[0] == ' ') && (attrib[0] == 0)) {
+      row_blank( win, y );
+      return;
+   }
+   size = sizeof(RUNS) + (count - 1) * sizeof(RUN);
+   if (size >= row_size( win->width ))
+      return;
+   runs = pool_alloc( size );
+   if (runs == NULL)
+      return;
+
+   runs->count = count;
+   for (i = -1, x = 0; x < win->width; x++) {
+      if ((x == 0) || (text[x] != text[x - 1]) || (attrib[x] != attrib[x - 1])) {
+	 i++;
+	 runs->run[ i ].wc = text[x];
+	 runs->run[ i ].attr = attrib[x];
+	 runs->run[ i ].len = 0;
+      }
+      runs->run[ i ].len++;
+   }
+   pool_free( win->lines[y] );
+   win->lines[y] = NULL;
+   win->alines[y] = NULL;
+   win->runs[y] = runs;
+}
 
-   while ( !key_pressed ) {
+/* free the rows of a compressed window, leaving them blank */
+static void free_rows(WINDOW *win)
+{
+   int row;
 
+   if (win->runs == NULL)
+      return;
+   for (row = 0; row < win->height; row++)
+      row_blank( win, row );
+}
 
-      if ((win->delay) || (cbreak == FALSE))
-      {
-	 while ( SDL_WaitEvent( &event ) == 0 ) {
-	    SDL_PumpEvents();
-	 };
-      } else {
-	 if (!SDL_PollEvent( &event ))
-	    return ERR;
-      }
+/* pack every expanded row of a compressed window */
+static void pack_rows(WINDOW *win)
+{
+   int row;
 
-      if ( ( event.type == SDL_KEYUP ) && ( event.key.keysym.scancode == last_keysym.scancode ) )
-	 last_keysym.scancode = 0;
+   for (row = 0; row < win->height; row++)
+      row_pack( win, row );
+}
 
-      if ( event.type == SDL_KEYDOWN )
-      {
-	 last_keysym = event.key.keysym;
-
-	 /* fprintf(stderr, "wgetch event.key.keysym.sym %x\n", event.key.keysym.sym ); */
-	 switch ( event.key.keysym.sym ) 
-	 {
-	    
-
-	    case SDLK_UP: 
-	    case SDLK_DOWN: 
-	    case SDLK_LEFT: 
-	    case SDLK_RIGHT: 
-	    case SDLK_PAGEDOWN: 
-	    case SDLK_PAGEUP: 
-	    case SDLK_HOME: 
-	    case SDLK_END: 
-	    case SDLK_F1:
-	    case SDLK_F2:
-	    case SDLK_F3:
-	    case SDLK_F4:
-	    case SDLK_F5:
-	    case SDLK_F6:
-	    case SDLK_F7:
-	    case SDLK_F8:
-	    case SDLK_F9:
-	    case SDLK_F11:
-	    case SDLK_F12:
-	    case SDLK_F13:
-	    case SDLK_F14:
-	    case SDLK_F15:
-	    {
-	       retchar = event.key.keysym.sym;
-	       break;
-	    }
+/* pack the rows expanded since this last ran, while waiting for input */
+static void pack_idle(void)
+{
+   WINDOW *win;
+
+   if (!SP->pack_due)
+      return;
+   SP->pack_due = FALSE;
+   for (win = SP->windows; win != NULL; win = win->next)
+      if (win->runs != NULL)
+	 pack_rows( win );
+}
 
-	    case SDLK_KP0:
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '0';
-	       }
-	       break;
+/*
+ * frame recording
+ */
 
-	    case SDLK_KP1:
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '1';
-	       }
-	       break;
+/* recordframes writes what is drawn on a screen to a stream that
+ * replayframes plays back.  The stream starts with RECORD_MAGIC, a
+ * version byte and the screen's lines and columns, then has records
+ * of a tag byte and numbers, each an unsigned LEB128 varint:
+ *
+ *   'F' ms, then spans of row + 1, column, n and runs of len, char,
+ *       attributes covering the n cells, then 0: the cells a refresh
+ *       drew, in screen coordinates
+ *   'C' color, r, g, b: a colour as it is drawn, 0..255
+ *   'P' pair, foreground, background
+ *   'S' lines, columns: the screen was resized
+ *   'K' ms, code, fkey, mod: a key was read
+ *
+ * ms counts from the start of the recording.  The colours and pairs
+ * are all written when recording starts and again as they change. */
+#define RECORD_MAGIC "SDLcrec"
+#define RECORD_VERSION (1)
+
+static void put_varint(FILE *f, unsigned long v)
+{
+   while (v >= 0x80) {
+      putc( (int) (v & 0x7f) | 0x80, f );
+      v >>= 7;
+   }
+   putc( (int) v, f );
+}
 
-	    case SDLK_KP3:
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '3';
-	       }
-	       break;
+/* read a varint into *v, FALSE at the end of the stream */
+static bool get_varint(FILE *f, unsigned long *v)
+{
+   unsigned int shift = 0;
+   int c;
+
+   *v = 0;
+   do {
+      c = getc( f );
+      if ((c == EOF) || (shift >= sizeof(unsigned long) * 8))
+	 return FALSE;
+      *v |= (unsigned long) (c & 0x7f) << shift;
+      shift += 7;
+   } while (c & 0x80);
+   return TRUE;
+}
 
-	    case SDLK_KP5:
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '5';
-	       }
-	       break;
+static void record_color(int color)
+{
+   putc( 'C', SP->record );
+   put_varint( SP->record, color );
+   put_varint( SP->record, color_pots[color].r );
+   put_varint( SP->record, color_pots[color].g );
+   put_varint( SP->record, color_pots[color].b );
+}
 
-	    case SDLK_KP7:
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '7';
-	       }
-	       break;
+static void record_pair(int pair)
+{
+   putc( 'P', SP->record );
+   put_varint( SP->record, pair );
+   put_varint( SP->record, (unsigned short) color_pairs[pair * 2 + 1] );
+   put_varint( SP->record, (unsigned short) color_pairs[pair * 2] );
+}
 
-	    case SDLK_KP9:
-	    {
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '9';
-	       }
-	       break;
-	    }
-	    
-	    case SDLK_KP2:
-	    {
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '2';
-		  break;
-	       }
-	       if (win->keypad_on)
-		  retchar = SDLK_DOWN;
-	       break;
-	    }
-	    case SDLK_KP6:
-	    {
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '6';
-		  break;
-	       } 
-	       if (win->keypad_on) {
-		  retchar = SDLK_RIGHT;
-	       }
-	       break;
-	    }
-	    case SDLK_KP4:
-	    {
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '4'; 
-		  break;
-	       }
-	       if (win->keypad_on)
-		  retchar = SDLK_LEFT;
-	       break;
-	    }
+/* record columns x0..xend - 1 of row y of win as drawn by a refresh */
+static void record_span(WINDOW *win, int y, int x0, int xend)
+{
+   FILE *f = SP->record;
+   wchar_t wc;
+   attr_t attrs;
+   int x, len;
+
+   if ((win->y + y < 0) || (win->x + x0 < 0))
+      return;
+   if (!SP->record_frame) {
+      putc( 'F', f );
+      put_varint( f, SDL_GetTicks() - SP->record_start );
+      SP->record_frame = TRUE;
+   }
+   put_varint( f, win->y + y + 1 );
+   put_varint( f, win->x + x0 );
+   put_varint( f, xend - x0 );
+   for (x = x0; x < xend; x += len) {
+      wc = cell_char( win, y, x );
+      attrs = cell_attrib( win, y, x );
+      for (len = 1; (x + len < xend) && (cell_char( win, y, x + len ) == wc) &&
+	      (cell_attrib( win, y, x + len ) == attrs); len++)
+	 ;
+      put_varint( f, len );
+      put_varint( f, wc );
+      put_varint( f, attrs );
+   }
+}
 
-	    case SDLK_KP8:
-	    {
-	       retchar = event.key.keysym.sym;
-	       if (event.key.keysym.mod & KMOD_NUM) {
-		  retchar = '8';
-		  break;
-	       }
-	       if (win->keypad_on)
-		  retchar = SDLK_UP;
-	       break;
-	    }
+/* close the frame a refresh recorded, if it drew anything */
+static void record_frame_end(void)
+{
+   if (!SP->record_frame)
+      return;
+   put_varint( SP->record, 0 );
+   SP->record_frame = FALSE;
+}
 
-	    default:
-	       if ((echo_on) && (event.key.keysym.unicode)) {
-		  waddch(win, event.key.keysym.unicode);
-		  wrefresh(win);
-		  SDL_PumpEvents();
-	       }
-	       retchar = event.key.keysym.unicode;
-	       break;
+static void record_key(const KEY_EVENT *key)
+{
+   putc( 'K', SP->record );
+   put_varint( SP->record, key->ticks - SP->record_start );
+   put_varint( SP->record, (unsigned int) key->code );
+   put_varint( SP->record, key->fkey );
+   put_varint( SP->record, key->mod );
+}
 
-	 } /* switch */
+/*
+ * shared memory mirror
+ */
 
-	 if (cbreak_on == FALSE) {
-	    if  (retchar != '\r') {
-	       if (((push_index + 1) % MAX_INPUT_PENDING) != pop_index) {
-		  inbuffer[push_index] = retchar;
-		  push_index = ( push_index + 1 ) % MAX_INPUT_PENDING;
-	       }		     
-	    }  else {
-	       key_pressed = TRUE;
-	    }
-	 } else {
-	    key_pressed = TRUE;
-	 }
-	 break;
-	 
-      }
+/* shmmirror keeps a copy of the screen's cells in shared memory for
+ * other processes to read.  The cells each refresh draws are stored
+ * straight into it in screen coordinates, so it holds the screen as
+ * its windows were composed on it, with no copy of its own.  A
+ * refresh is one seqlock write: seq goes odd at its first span and
+ * even again at its end, when the frame counter and cursor are set.
+ * Readers never hold up the writer. */
+#if defined(SDL_CURSES_POSIX) && defined(__GNUC__)
+#define SDL_CURSES_MIRROR
+#endif
 
-      if ( event.type == SDL_QUIT ) {
-	 TTF_Quit();
-	 SDL_Quit();
-	 exit( 0 );
+#ifdef SDL_CURSES_POSIX
+
+static void blank_mirror_cells(MIRROR_CELL *cells, size_t n)
+{
+   while (n-- > 0) {
+      cells->wc = ' ';
+      cells->attr = 0;
+      cells++;
+   }
+}
+
+/* lay cells holding old_lines by old_cols out again as lines by cols,
+ * keeping what is in both sizes and blanking the rest; there must be
+ * room for both */
+static void relay_cells(MIRROR_CELL *cells, int old_lines, int old_cols, int lines, int cols)
+{
+   int keep = (lines < old_lines) ? lines : old_lines;
+   int y;
+
+   if (cols <= old_cols) {
+      for (y = 0; y < keep; y++)
+	 memmove( cells + y * cols, cells + y * old_cols, cols * sizeof(MIRROR_CELL) );
+   } else {
+      for (y = keep - 1; y >= 0; y--) {
+	 memmove( cells + y * cols, cells + y * old_cols, old_cols * sizeof(MIRROR_CELL) );
+	 blank_mirror_cells( cells + y * cols + old_cols, cols - old_cols );
       }
+   }
+   blank_mirror_cells( cells + keep * cols, (size_t) (lines - keep) * cols );
+}
 
-      if (( !key_pressed ) && ( win->delay ))
-	 SDL_PumpEvents();
+#endif /* SDL_CURSES_POSIX */
 
-      if ( !win->delay )
-	 break;
-   } /* while !key_pressed */
+typedef struct s_Mirror
+{
+      SCREEN_MIRROR *head;	/* the mapped object */
+      MIRROR_CELL *cells;
+      size_t size;		/* bytes mapped */
+      int fd;
+      bool writing;		/* seq is odd */
+      char name[1];
+} MIRROR;
 
-   /* bodge.. */
-   if (retchar == '\r')
-      retchar = '\n';
+#ifdef SDL_CURSES_MIRROR
 
-   /* fprintf(stderr, "wgetchar returning %x in delay %x cbreak %x\n", retchar, win->delay, cbreak_on); */
-   return ( retchar );
+static void mirror_begin(MIRROR *m)
+{
+   if (m->writing)
+      return;
+   __atomic_store_n( &m->head->seq, m->head->seq + 1, __ATOMIC_RELAXED );
+   __atomic_thread_fence( __ATOMIC_RELEASE );
+   m->writing = TRUE;
 }
 
-int cbreak(void)
+static void mirror_end(MIRROR *m)
 {
-   cbreak_on = TRUE;
-   return OK;
+   if (!m->writing)
+      return;
+   m->head->cursor_row = SP->cursor_row;
+   m->head->cursor_col = SP->cursor_col;
+   m->head->frame++;
+   __atomic_store_n( &m->head->seq, m->head->seq + 1, __ATOMIC_RELEASE );
+   m->writing = FALSE;
 }
 
-int nocbreak(void)
+/* make the mirror lines by cols, growing the object if it must,
+ * keeping what is in both sizes and blanking the rest */
+static bool mirror_size(MIRROR *m, int lines, int cols)
 {
-   cbreak_on = FALSE;
-   return OK;
+   size_t need = sizeof(SCREEN_MIRROR) + (size_t) lines * cols * sizeof(MIRROR_CELL);
+   void *map;
+
+   if (need > m->size) {
+      if (ftruncate( m->fd, need ) != 0)
+	 return FALSE;
+      map = mmap( NULL, need, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0 );
+      if (map == MAP_FAILED)
+	 return FALSE;
+      if (m->head != NULL)
+	 munmap( m->head, m->size );
+      m->head = map;
+      m->cells = (MIRROR_CELL *) ((Uint8 *) map + sizeof(SCREEN_MIRROR));
+      m->size = need;
+      m->head->capacity = (Uint32) ((need - sizeof(SCREEN_MIRROR)) / sizeof(MIRROR_CELL));
+   }
+
+   mirror_begin( m );
+   relay_cells( m->cells, m->head->lines, m->head->cols, lines, cols );
+   m->head->lines = lines;
+   m->head->cols = cols;
+   return TRUE;
 }
 
-int crmode(void)
+/* store columns x0..xend - 1 of row y of win in the mirror */
+static void mirror_span(MIRROR *m, WINDOW *win, int y, int x0, int xend)
 {
-   return cbreak();
+   int row = win->y + y;
+   int col = win->x + x0;
+   MIRROR_CELL *cell;
+   int x;
+
+   if ((row < 0) || (row >= (int) m->head->lines) || (col < 0))
+      return;
+   if (xend - x0 > (int) m->head->cols - col)
+      xend = x0 + m->head->cols - col;
+   mirror_begin( m );
+   cell = m->cells + row * m->head->cols + col;
+   for (x = x0; x < xend; x++, cell++) {
+      cell->wc = cell_char( win, y, x );
+      cell->attr = cell_attrib( win, y, x );
+   }
 }
 
-int nodelay(WINDOW *win, bool bf)
+#endif /* SDL_CURSES_MIRROR */
+
+/*
+ * cell streaming
+ */
+
+/* streamcells serves the cells each refresh draws to viewers in other
+ * processes over a Unix domain socket.  A viewer is sent messages of
+ * a four byte big-endian length, counting what follows, a type byte
+ * and a payload of varints like those of a recording:
+ *
+ *   'H' version: sent first
+ *   'C' r, g, b of each colour then foreground, background of each
+ *       pair: the palette, sent before keyframes and when it changes
+ *   'K' lines, columns, then runs of len, char, attributes covering
+ *       the screen row by row: a keyframe
+ *   'F' spans of row + 1, column, n and runs as in a recording, then
+ *       0: the cells one refresh drew
+ *
+ * A type with STREAM_PACKED set has a payload of its unpacked length
+ * and the LZ packing of it.  That is a series of tags: one below 0x80
+ * is followed by tag + 1 literal bytes; any other copies (tag & 0x7f)
+ * + 3 bytes from as far back in the output as the two byte
+ * little-endian distance after it says.
+ *
+ * Nothing here blocks.  What a viewer has not taken yet is queued, and
+ * once STREAM_QUEUE bytes are waiting its frames are dropped instead.
+ * When its queue has drained it is sent a keyframe, made from the copy
+ * of the screen kept here, and carries on from that. */
+#ifdef SDL_CURSES_POSIX
+#define SDL_CURSES_STREAM
+#endif
+
+#define STREAM_VERSION (1)
+#define STREAM_PACKED (0x80)
+#define STREAM_PACK_MIN (64)		/* smaller payloads go as they are */
+#define STREAM_QUEUE (1024 * 1024)
+#define LZ_HASH_BITS (12)
+#define LZ_MAX_MATCH (0x7f + 3)
+#define LZ_MAX_DISTANCE (0xffff)
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL (0)
+#define STREAM_IGNORE_SIGPIPE		/* there being no other way */
+#endif
+
+typedef struct s_Bytes
 {
-   win->delay = bf;
-   return OK;
+      Uint8 *data;
+      size_t used, size;
+} BYTES;
+
+typedef struct s_Viewer
+{
+      struct s_Viewer *next;
+      int fd;
+      BYTES queue;		/* whole messages not yet sent */
+      size_t sent;		/* how much of the queue has been */
+      bool behind;		/* is owed a keyframe */
+} VIEWER;
+
+typedef struct s_Stream
+{
+      int fd;			/* the listening socket */
+      VIEWER *viewers;
+      MIRROR_CELL *cells;	/* the screen, as the viewers are to have it */
+      int lines, cols;
+      BYTES frame;		/* the spans of the refresh under way */
+      BYTES message;
+      bool palette_due;		/* the palette changed since it was sent */
+      char path[1];
+} STREAM;
+
+/* growable byte buffers, for the stream and the terminal */
+#ifdef SDL_CURSES_POSIX
+
+static bool bytes_put(BYTES *b, const void *data, size_t n)
+{
+   size_t size;
+   Uint8 *grown;
+
+   if (b->used + n > b->size) {
+      for (size = (b->size != 0) ? b->size : 256; size < b->used + n; size *= 2)
+	 ;
+      grown = realloc( b->data, size );
+      if (grown == NULL)
+	 return FALSE;
+      b->data = grown;
+      b->size = size;
+   }
+   memcpy( b->data + b->used, data, n );
+   b->used += n;
+   return TRUE;
 }
 
-int keypad(WINDOW *win, bool bf)
+static bool bytes_byte(BYTES *b, int c)
 {
-   win->keypad_on = bf;
-   return OK;
+   Uint8 byte = (Uint8) c;
+
+   return bytes_put( b, &byte, 1 );
 }
 
-int mvwgetch(WINDOW *win, int y, int x)
+static bool bytes_varint(BYTES *b, unsigned long v)
 {
-   if (wmove(win, y, x) != OK)
-      return ERR;
-   return wgetch(win);
+   Uint8 buf[ 10 ];
+   size_t n = 0;
+
+   while (v >= 0x80) {
+      buf[n++] = (Uint8) ((v & 0x7f) | 0x80);
+      v >>= 7;
+   }
+   buf[n++] = (Uint8) v;
+   return bytes_put( b, buf, n );
 }
 
-int refresh( void )
+static void bytes_free(BYTES *b)
 {
-   return wrefresh(stdscr);
+   free( b->data );
+   b->data = NULL;
+   b->used = b->size = 0;
 }
 
-int move( int y, int x )
+#endif /* SDL_CURSES_POSIX */
+
+#ifdef SDL_CURSES_STREAM
+
+static bool lz_literals(BYTES *out, const Uint8 *src, size_t n)
 {
-   return wmove(stdscr, y, x);
+   size_t chunk;
+
+   for (; n > 0; src += chunk, n -= chunk) {
+      chunk = (n < 0x80) ? n : 0x80;
+      if (!bytes_byte( out, (int) chunk - 1 ) || !bytes_put( out, src, chunk ))
+	 return FALSE;
+   }
+   return TRUE;
 }
 
-int getch(void)
+/* append the LZ packing of n bytes at src to out; matches are found
+ * through a table of where each three byte prefix was last seen */
+static bool lz_pack(BYTES *out, const Uint8 *src, size_t n)
 {
-   return wgetch(stdscr);
+   Uint32 last[ 1 << LZ_HASH_BITS ];
+   size_t i = 0, literal = 0, len, cand;
+   Uint32 h;
+
+   memset( last, 0xff, sizeof(last) );
+   while (i + 3 <= n) {
+      h = ((src[i] << 16 | src[i + 1] << 8 | src[i + 2]) * 2654435761U) >> (32 - LZ_HASH_BITS);
+      cand = last[h];
+      last[h] = (Uint32) i;
+      if ((cand == 0xffffffffU) || (i - cand > LZ_MAX_DISTANCE) ||
+	  (memcmp( src + cand, src + i, 3 ) != 0)) {
+	 i++;
+	 continue;
+      }
+      for (len = 3; (len < LZ_MAX_MATCH) && (i + len < n) && (src[cand + len] == src[i + len]); len++)
+	 ;
+      if (!lz_literals( out, src + literal, i - literal ) ||
+	  !bytes_byte( out, 0x80 | (int) (len - 3) ) ||
+	  !bytes_byte( out, (int) ((i - cand) & 0xff) ) ||
+	  !bytes_byte( out, (int) ((i - cand) >> 8) ))
+	 return FALSE;
+      i += len;
+      literal = i;
+   }
+   return lz_literals( out, src + literal, n - literal );
 }
 
-int mvgetch(int y, int x)
+/* make s->message a message of type with payload, packed if that
+ * makes it smaller */
+static bool stream_message(STREAM *s, int type, const BYTES *payload)
 {
-   if(move(x,y) != OK)
-      return ERR;
-   return getch();
+   BYTES *m = &s->message;
+   size_t n;
+
+   m->used = 0;
+   if (!bytes_put( m, "\0\0\0\0", 5 ))
+      return FALSE;
+   if (payload->used >= STREAM_PACK_MIN) {
+      if (!bytes_varint( m, payload->used ) || !lz_pack( m, payload->data, payload->used ))
+	 return FALSE;
+      if (m->used < 5 + payload->used)
+	 type |= STREAM_PACKED;
+      else
+	 m->used = 5;
+   }
+   if (!(type & STREAM_PACKED) && !bytes_put( m, payload->data, payload->used ))
+      return FALSE;
+   n = m->used - 4;
+   m->data[0] = (Uint8) (n >> 24);
+   m->data[1] = (Uint8) (n >> 16);
+   m->data[2] = (Uint8) (n >> 8);
+   m->data[3] = (Uint8) n;
+   m->data[4] = (Uint8) type;
+   return TRUE;
 }
 
-int addch(const chtype ch)
+/* append runs of len, char, attributes covering n cells */
+static bool stream_runs(BYTES *b, const MIRROR_CELL *cells, int n)
 {
-   return waddch(stdscr, ch);
+   int x, len;
+
+   for (x = 0; x < n; x += len) {
+      for (len = 1; (x + len < n) && (cells[x + len].wc == cells[x].wc) &&
+	      (cells[x + len].attr == cells[x].attr); len++)
+	 ;
+      if (!bytes_varint( b, len ) || !bytes_varint( b, cells[x].wc ) ||
+	  !bytes_varint( b, cells[x].attr ))
+	 return FALSE;
+   }
+   return TRUE;
 }
 
-int mvaddch(int y, int x, const chtype ch)
+/* queue s->message for v, unless v has fallen too far behind */
+static void viewer_queue(STREAM *s, VIEWER *v)
 {
-   if (move(y,x) != OK)
-      return ERR;
-   return addch(ch);
+   if (v->behind)
+      return;
+   if (((v->queue.used > v->sent) &&
+	(v->queue.used - v->sent + s->message.used > STREAM_QUEUE)) ||
+       !bytes_put( &v->queue, s->message.data, s->message.used ))
+      v->behind = TRUE;
 }
 
-int addstr(const char *str)
+static void stream_queue_all(STREAM *s)
 {
-   return waddstr(stdscr, str);
+   VIEWER *v;
+
+   for (v = s->viewers; v != NULL; v = v->next)
+      viewer_queue( s, v );
 }
 
-int addnstr(const char *str, int n)
+/* send v as much of its queue as its socket takes; FALSE once it has
+ * gone */
+static bool viewer_send(VIEWER *v)
 {
-   return waddnstr(stdscr, str, n);
+   ssize_t n;
+
+   while (v->sent < v->queue.used) {
+      n = send( v->fd, v->queue.data + v->sent, v->queue.used - v->sent,
+		MSG_DONTWAIT | MSG_NOSIGNAL );
+      if (n < 0) {
+	 if (errno == EINTR)
+	    continue;
+	 if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+	    return FALSE;
+	 /* keep what is left at the start of the queue */
+	 memmove( v->queue.data, v->queue.data + v->sent, v->queue.used - v->sent );
+	 v->queue.used -= v->sent;
+	 v->sent = 0;
+	 return TRUE;
+      }
+      v->sent += n;
+   }
+   v->queue.used = v->sent = 0;
+   return TRUE;
 }
 
-int mvaddstr(int y, int x, const char *str)
+/* make s->message the palette */
+static bool stream_palette(STREAM *s)
 {
-   return mvwaddstr(stdscr, y, x, str);
+   BYTES payload = { NULL, 0, 0 };
+   bool ok = TRUE;
+   int i;
+
+   for (i = 0; ok && (i < COLORS); i++)
+      ok = bytes_byte( &payload, color_pots[i].r ) && bytes_byte( &payload, color_pots[i].g ) &&
+	 bytes_byte( &payload, color_pots[i].b );
+   for (i = 0; ok && (i < COLOR_PAIRS); i++)
+      ok = bytes_varint( &payload, (unsigned short) color_pairs[i * 2 + 1] ) &&
+	 bytes_varint( &payload, (unsigned short) color_pairs[i * 2] );
+   ok = ok && stream_message( s, 'C', &payload );
+   bytes_free( &payload );
+   return ok;
 }
 
-int mvaddnstr(int y, int x, const char *str, int n)
+/* queue the palette and a keyframe for v, whose queue is empty */
+static void viewer_catch_up(STREAM *s, VIEWER *v)
 {
-   return mvwaddnstr(stdscr, y, x, str, n);
+   BYTES payload = { NULL, 0, 0 };
+   bool ok;
+   int y;
+
+   v->behind = FALSE;
+   if (stream_palette( s ))
+      viewer_queue( s, v );
+   ok = bytes_varint( &payload, s->lines ) && bytes_varint( &payload, s->cols );
+   for (y = 0; ok && (y < s->lines); y++)
+      ok = stream_runs( &payload, s->cells + y * s->cols, s->cols );
+   if (ok && stream_message( s, 'K', &payload ))
+      viewer_queue( s, v );
+   else
+      v->behind = TRUE;
+   bytes_free( &payload );
 }
 
-int printw(const char *fmt, ...)
+/* drop the frame under way and owe every viewer a keyframe */
+static void stream_resync(STREAM *s)
 {
-   va_list params;
-   int result;
+   VIEWER *v;
 
-   va_start(params, fmt);
-   result = vw_printw(stdscr, fmt, params);
-   va_end(params);
+   for (v = s->viewers; v != NULL; v = v->next)
+      v->behind = TRUE;
+   s->frame.used = 0;
+}
+
+static void viewer_free(VIEWER *v)
+{
+   close( v->fd );
+   bytes_free( &v->queue );
+   free( v );
+}
+
+/* take on viewers that have connected, and send each what it is owed */
+static void stream_pump(STREAM *s)
+{
+   VIEWER **link, *v;
+   BYTES hello = { NULL, 0, 0 };
+   bool alive;
+   int fd;
+
+   while ((fd = accept( s->fd, NULL, NULL )) >= 0) {
+      v = calloc( 1, sizeof(VIEWER) );
+      if ((v == NULL) || (fcntl( fd, F_SETFL, fcntl( fd, F_GETFL ) | O_NONBLOCK ) != 0)) {
+	 free( v );
+	 close( fd );
+	 continue;
+      }
+      v->fd = fd;
+      v->next = s->viewers;
+      s->viewers = v;
+      if (bytes_varint( &hello, STREAM_VERSION ) && stream_message( s, 'H', &hello ))
+	 viewer_queue( s, v );
+      hello.used = 0;
+      v->behind = TRUE;
+   }
+   bytes_free( &hello );
+
+   for (link = &s->viewers; (v = *link) != NULL; ) {
+      alive = viewer_send( v );
+      if (alive && v->behind && (v->queue.used == 0)) {
+	 viewer_catch_up( s, v );
+	 alive = viewer_send( v );
+      }
+      if (alive) {
+	 link = &v->next;
+      } else {
+	 *link = v->next;
+	 viewer_free( v );
+      }
+   }
+}
+
+/* store columns x0..xend - 1 of row y of win in the copy of the
+ * screen and add them to the frame */
+static void stream_span(STREAM *s, WINDOW *win, int y, int x0, int xend)
+{
+   int row = win->y + y;
+   int col = win->x + x0;
+   MIRROR_CELL *cell;
+   int x;
+
+   if ((row < 0) || (row >= s->lines) || (col < 0) || (col >= s->cols))
+      return;
+   if (xend - x0 > s->cols - col)
+      xend = x0 + s->cols - col;
+   cell = s->cells + row * s->cols + col;
+   for (x = x0; x < xend; x++, cell++) {
+      cell->wc = cell_char( win, y, x );
+      cell->attr = cell_attrib( win, y, x );
+   }
+   if (s->viewers == NULL)
+      return;
+   if (!bytes_varint( &s->frame, row + 1 ) || !bytes_varint( &s->frame, col ) ||
+       !bytes_varint( &s->frame, xend - x0 ) ||
+       !stream_runs( &s->frame, s->cells + row * s->cols + col, xend - x0 ))
+      /* too little memory to send it: have them all start again */
+      stream_resync( s );
+}
+
+/* send a refresh's spans as one message, and the palette before them
+ * if it has changed */
+static void stream_frame_end(STREAM *s)
+{
+   if (s->palette_due) {
+      s->palette_due = FALSE;
+      if (stream_palette( s ))
+	 stream_queue_all( s );
+      else
+	 stream_resync( s );
+   }
+   if (s->frame.used > 0) {
+      if (bytes_varint( &s->frame, 0 ) && stream_message( s, 'F', &s->frame ))
+	 stream_queue_all( s );
+      else
+	 stream_resync( s );
+      s->frame.used = 0;
+   }
+   stream_pump( s );
+}
+
+/* the screen is now lines by cols; FALSE if there is too little
+ * memory for the copy of it */
+static bool stream_size(STREAM *s, int lines, int cols)
+{
+   MIRROR_CELL *cells = s->cells;
+   size_t old_n = (size_t) s->lines * s->cols;
+   size_t n = (size_t) lines * cols;
+
+   if (n > old_n) {
+      cells = realloc( cells, n * sizeof(MIRROR_CELL) );
+      if (cells == NULL)
+	 return FALSE;
+      s->cells = cells;
+   }
+   relay_cells( cells, s->lines, s->cols, lines, cols );
+   s->lines = lines;
+   s->cols = cols;
+   stream_resync( s );
+   return TRUE;
+}
+
+#endif /* SDL_CURSES_STREAM */
+
+/*
+ * change tracking
+ */
+
+/* note that columns x0..x1 of row y have changed since the last refresh */
+static void touch_span(WINDOW *win, int y, int x0, int x1)
+{
+   if ((y < 0) || (y >= win->height))
+      return;
+   if (x0 < 0)
+      x0 = 0;
+   if (x1 >= win->width)
+      x1 = win->width - 1;
+   if (x0 > x1)
+      return;
+   if ((win->firstch[y] == _NOCHANGE) || (x0 < win->firstch[y]))
+      win->firstch[y] = x0;
+   if ((win->lastch[y] == _NOCHANGE) || (x1 > win->lastch[y]))
+      win->lastch[y] = x1;
+   if (win->backing != NULL)
+      backing_touch( win->backing, y, x0, x1 );
+}
+
+/* note that rows start..start + count - 1 have changed in full */
+static void touch_rows(WINDOW *win, int start, int count)
+{
+   int row;
+
+   for (row = start; (row < start + count) && (row < win->height); row++)
+      touch_span( win, row, 0, win->width - 1 );
+}
+
+static bool grow_update_rects(int n)
+{
+   SDL_Rect *rects;
+
+   if (n <= SP->update_rects_size)
+      return TRUE;
+   rects = realloc( SP->update_rects, n * sizeof(SDL_Rect) );
+   if (rects == NULL)
+      return FALSE;
+   SP->update_rects = rects;
+   SP->update_rects_size = n;
+   return TRUE;
+}
+
+/* the attributes a character is stored with: its own combined with
+ * the window's current ones, its own colour pair taking precedence */
+static attr_t cell_attr(WINDOW *win, chtype c)
+{
+   attr_t attrs = win->attributes | (c & A_ATTRIBUTES);
+
+   if (c & A_COLOR)
+      attrs = (attrs & ~A_COLOR) | (c & A_COLOR);
+   return attrs;
+}
+
+/* the number of columns a character takes: 2 for the East Asian wide
+ * and fullwidth forms, 0 for combining marks, 1 for everything else */
+static int char_cells(wchar_t wc)
+{
+   if (((wc >= 0x0300) && (wc <= 0x036F)) ||
+       ((wc >= 0x1AB0) && (wc <= 0x1AFF)) ||
+       ((wc >= 0x1DC0) && (wc <= 0x1DFF)) ||
+       ((wc >= 0x20D0) && (wc <= 0x20FF)) ||
+       ((wc >= 0xFE20) && (wc <= 0xFE2F)) ||
+       (wc == 0x200B))
+      return 0;
+   if (((wc >= 0x1100) && (wc <= 0x115F)) ||
+       ((wc >= 0x2E80) && (wc <= 0xA4CF) && (wc != 0x303F)) ||
+       ((wc >= 0xAC00) && (wc <= 0xD7A3)) ||
+       ((wc >= 0xF900) && (wc <= 0xFAFF)) ||
+       ((wc >= 0xFE30) && (wc <= 0xFE4F)) ||
+       ((wc >= 0xFF00) && (wc <= 0xFF60)) ||
+       ((wc >= 0xFFE0) && (wc <= 0xFFE6)) ||
+       ((wc >= 0x20000) && (wc <= 0x3FFFD)))
+      return 2;
+   return 1;
+}
+
+/* U+FFFF marks the second half of a double-width character, so one
+ * that comes in as text is stored as U+FFFD instead */
+static wchar_t text_char(wchar_t wc)
+{
+   return (wc == WIDE_FILLER) ? (wchar_t) 0xFFFD : wc;
+}
+
+/* what to store after prev when a frame or dump holds wc: a filler
+ * that does not follow a double-width character is left blank */
+static wchar_t stored_char(wchar_t prev, wchar_t wc)
+{
+   return ((wc == WIDE_FILLER) && (char_cells( prev ) != 2)) ? (wchar_t) ' ' : wc;
+}
+
+/* whether the cell at row y, column x is the second half of a
+ * double-width character */
+static bool is_covered(WINDOW *win, int y, int x)
+{
+   return (x > 0) && (cell_char( win, y, x ) == WIDE_FILLER) &&
+      (char_cells( cell_char( win, y, x - 1 ) ) == 2);
+}
+
+/* if column x of row y is half of a double-width character, blank
+ * both halves, so that neither is left showing half a glyph */
+static void split_wide(WINDOW *win, int y, int x)
+{
+   if ((x < 0) || (x >= win->width) || !row_expand( win, y ))
+      return;
+   if (is_covered( win, y, x ))
+      x--;
+   else if ((char_cells( win->lines[y][x] ) != 2) || (x + 1 >= win->width) ||
+	    (win->lines[y][x + 1] != WIDE_FILLER))
+      return;
+   win->lines[y][x] = ' ';
+   win->lines[y][x + 1] = ' ';
+   touch_span( win, y, x, x + 1 );
+}
+
+/* store wc at row y, column x without touching the change tracking;
+ * a double-width character also takes column x + 1, or is replaced
+ * by a blank if that is past the edge */
+static void put_wcell(WINDOW *win, int y, int x, wchar_t wc, attr_t attrs)
+{
+   int cells;
+
+   wc = text_char( wc );
+   cells = char_cells( wc );
+
+   if (!row_expand( win, y ))
+      return;
+   split_wide( win, y, x );
+   if (cells == 2) {
+      if (x + 1 >= win->width)
+	 wc = ' ';
+      else {
+	 split_wide( win, y, x + 1 );
+	 win->lines[y][x + 1] = WIDE_FILLER;
+	 win->alines[y][x + 1] = attrs;
+      }
+   }
+   win->lines[y][x] = wc;
+   win->alines[y][x] = attrs;
+   mark_blink( win, y, attrs );
+}
+
+/* a double-width character shifted into the last column of expanded
+ * row y has lost its second half past the edge, so it goes */
+static void clip_wide(WINDOW *win, int y)
+{
+   if (char_cells( win->lines[y][ win->width - 1 ] ) == 2)
+      win->lines[y][ win->width - 1 ] = ' ';
+}
+
+/* store ch at row y, column x without touching the change tracking */
+static void put_cell(WINDOW *win, int y, int x, chtype ch)
+{
+   put_wcell( win, y, x, (wchar_t) (ch & A_CHARTEXT), cell_attr( win, ch ) );
+}
+
+/* store ch in columns x0..x1 of row y without touching the change
+ * tracking; callers mark the whole span at once */
+static void fill_row(WINDOW *win, int y, int x0, int x1, chtype ch)
+{
+   attr_t attrs = cell_attr( win, ch );
+   int x;
+
+   if ((x0 > x1) || !row_expand( win, y ))
+      return;
+   split_wide( win, y, x0 );
+   split_wide( win, y, x1 );
+   for (x = x0; x <= x1; x++) {
+      win->lines[y][x] = (wchar_t) (ch & A_CHARTEXT);
+      win->alines[y][x] = attrs;
+   }
+   mark_blink( win, y, attrs );
+}
+
+/* fill columns x0..x1 of row y with blanks */
+static void blank_span(WINDOW *win, int y, int x0, int x1)
+{
+   int x;
+
+   /* a whole row of a compressed window needs no cells at all */
+   if ((win->runs != NULL) && (x0 == 0) && (x1 == win->width - 1)) {
+      row_blank( win, y );
+      return;
+   }
+   if (!row_expand( win, y ))
+      return;
+   split_wide( win, y, x0 );
+   split_wide( win, y, x1 );
+   for (x = x0; x <= x1; x++) {
+      win->lines[y][x] = ' ';
+      win->alines[y][x] = 0;
+   }
+}
+
+/* the character of a UTF-8 sequence at s, which is at most n bytes
+ * long (-1 for no limit), setting *used to its length.  A byte that
+ * does not start a valid sequence stands for itself, as Latin-1. */
+static wchar_t utf8_decode(const char *s, int n, int *used)
+{
+   const unsigned char *u = (const unsigned char *) s;
+   wchar_t wc;
+   int len, i;
+
+   if (u[0] < 0xC2) {
+      *used = 1;
+      return u[0];
+   }
+   if (u[0] < 0xE0) {
+      len = 2;
+      wc = u[0] & 0x1F;
+   } else if (u[0] < 0xF0) {
+      len = 3;
+      wc = u[0] & 0x0F;
+   } else if (u[0] < 0xF5) {
+      len = 4;
+      wc = u[0] & 0x07;
+   } else {
+      *used = 1;
+      return u[0];
+   }
+   if ((n >= 0) && (len > n)) {
+      *used = 1;
+      return u[0];
+   }
+   for (i = 1; i < len; i++) {
+      if ((u[i] & 0xC0) != 0x80) {
+	 *used = 1;
+	 return u[0];
+      }
+      wc = (wc << 6) | (u[i] & 0x3F);
+   }
+   /* overlong forms and surrogates are not characters */
+   if (((len == 3) && (wc < 0x800)) || ((len == 4) && (wc < 0x10000)) ||
+       ((wc >= 0xD800) && (wc <= 0xDFFF)) || (wc > 0x10FFFF)) {
+      *used = 1;
+      return u[0];
+   }
+   *used = len;
+   return wc;
+}
+
+/* write c to utf8 as UTF-8, returning the number of bytes, 1 to 4 */
+static int utf8_encode(Uint32 c, Uint8 *utf8)
+{
+   if (c < 0x80) {
+      utf8[0] = (Uint8) c;
+      return 1;
+   }
+   if (c < 0x800) {
+      utf8[0] = (Uint8) (0xc0 | (c >> 6));
+      utf8[1] = (Uint8) (0x80 | (c & 0x3f));
+      return 2;
+   }
+   if (c < 0x10000) {
+      utf8[0] = (Uint8) (0xe0 | (c >> 12));
+      utf8[1] = (Uint8) (0x80 | ((c >> 6) & 0x3f));
+      utf8[2] = (Uint8) (0x80 | (c & 0x3f));
+      return 3;
+   }
+   utf8[0] = (Uint8) (0xf0 | (c >> 18));
+   utf8[1] = (Uint8) (0x80 | ((c >> 12) & 0x3f));
+   utf8[2] = (Uint8) (0x80 | ((c >> 6) & 0x3f));
+   utf8[3] = (Uint8) (0x80 | (c & 0x3f));
+   return 4;
+}
+
+
+/*
+ * terminal
+ */
+
+/* A screen on a terminal draws no pixels.  Its refreshes hand the
+ * cells they draw to the terminal sink, which keeps two copies of the
+ * screen: want, the cells as the refreshes have left them, and shown,
+ * what the terminal is known to show, as the character printed and
+ * the pen (colours and renditions) it was printed in.  At the end of
+ * a refresh the rows that changed are compared and the cells that
+ * differ are sent as ANSI (ECMA-48) sequences, all in one write():
+ *
+ *   the cursor gets to each run of them by whichever of an absolute
+ *   move, relative moves, carriage return, backspace, line feed or
+ *   printing what is already there again takes the fewest bytes;
+ *   a row that ends in enough changed blanks is finished with erase
+ *   to end of line, which fills with the pen's background as xterm,
+ *   its kin and the Linux console do;
+ *   the pen is changed by one SGR with only what differs, or with a
+ *   reset and what is wanted, whichever is shorter.
+ *
+ * Colours 0..15 are the terminal's own sixteen and the rest its 256
+ * colour palette, so init_color does not reach the terminal; the
+ * colours of pair 0 are the terminal's default ones.  Characters go
+ * out as UTF-8, the line drawing ones as their Unicode forms. */
+#ifdef SDL_CURSES_POSIX
+#define SDL_CURSES_TTY
+#endif
+
+#define TTY_UNKNOWN (0xFFFFFFFFU)	/* a shown cell that must be sent */
+#define TTY_ERASE_MIN (4)	/* changed blanks that make erasing worth it */
+#define TTY_ESCAPE_MS (30)	/* for the rest of an escape sequence */
+#define TTY_POLL_MS (10)	/* between looks at the other sinks */
+
+/* a pen is the colours plus one, 0 for the default, and renditions */
+#define PEN_FG(pen) ((int) ((pen) & 0x1ff) - 1)
+#define PEN_BG(pen) ((int) (((pen) >> 9) & 0x1ff) - 1)
+#define PEN_COLORS (0x3ffffU)
+#define PEN_BOLD (1U << 18)
+#define PEN_DIM (1U << 19)
+#define PEN_UNDERLINE (1U << 20)
+#define PEN_BLINK (1U << 21)
+#define PEN_REVERSE (1U << 22)
+#define PEN_INVIS (1U << 23)
+
+#ifdef SDL_CURSES_TTY
+
+typedef struct s_Tty
+{
+      int out, in;		/* file descriptors */
+      bool raw;			/* in the mode set here, not suspended */
+      bool has_mode;		/* in is a terminal, saved its mode */
+      struct termios saved;
+      MIRROR_CELL *want;	/* char and attributes */
+      MIRROR_CELL *shown;	/* char printed and pen */
+      int *first, *last;	/* the columns of want changed in each row */
+      int lines, cols;
+      int row, col;		/* the cursor, -1 where it is not known */
+      Uint32 pen;		/* TTY_UNKNOWN if not known */
+      int cursor_visibility;	/* as the terminal has it, -1 not known */
+      BYTES buf;		/* the frame being written */
+      Uint8 input[ 32 ];	/* bytes read, not yet made keys */
+      int input_len;
+      Uint32 input_ticks;	/* SDL_GetTicks() when the last arrived */
+      struct s_Tty *next_active;	/* in tty_active, while raw */
+} TTY;
+
+static TTY *tty_active = NULL;	/* the terminals to put back at exit */
+static volatile sig_atomic_t tty_winched = 0;
+
+static void tty_puts(TTY *t, const char *s)
+{
+   bytes_put( &t->buf, s, strlen( s ) );
+}
+
+/* CSI n final, n left out when it is 1 */
+static void tty_csi(TTY *t, int n, char final)
+{
+   char seq[ 16 ];
+
+   if (n == 1)
+      sprintf( seq, "\033[%c", final );
+   else
+      sprintf( seq, "\033[%d%c", n, final );
+   tty_puts( t, seq );
+}
+
+static int digits(int n)
+{
+   int d = 1;
+
+   while (n >= 10) {
+      n /= 10;
+      d++;
+   }
+   return d;
+}
+
+static int csi_cost(int n)
+{
+   return (n == 1) ? 3 : 3 + digits( n );
+}
+
+/* the pen attributes are drawn in, the colours of pair 0 being the
+ * terminal's defaults */
+static Uint32 tty_pen(attr_t attrs)
+{
+   int fg = FG( PAIR_NUMBER( attrs ) );
+   int bg = BG( PAIR_NUMBER( attrs ) );
+   Uint32 pen = 0;
+
+   if (fg != color_pairs[1])
+      pen |= (fg & 0xff) + 1;
+   if (bg != color_pairs[0])
+      pen |= ((bg & 0xff) + 1) << 9;
+   if (attrs & (A_BOLD | A_STANDOUT))
+      pen |= PEN_BOLD;
+   if (attrs & A_DIM)
+      pen |= PEN_DIM;
+   if (attrs & A_UNDERLINE)
+      pen |= PEN_UNDERLINE;
+   if (attrs & A_BLINK)
+      pen |= PEN_BLINK;
+   if (attrs & A_REVERSE)
+      pen |= PEN_REVERSE;
+   if (attrs & A_INVIS)
+      pen |= PEN_INVIS;
+   return pen;
+}
+
+/* the character printed for wc: line graphics as their Unicode forms,
+ * control characters as '?' */
+static Uint32 tty_char(wchar_t wc, attr_t attrs)
+{
+   if (ALTCHARSET( attrs )) {
+      switch (wc) {
+	 case 'l': return 0x250C;
+	 case 'm': return 0x2514;
+	 case 'k': return 0x2510;
+	 case 'j': return 0x2518;
+	 case 't': return 0x251C;
+	 case 'u': return 0x2524;
+	 case 'v': return 0x2534;
+	 case 'w': return 0x252C;
+	 case 'q': return 0x2500;
+	 case 'x': return 0x2502;
+	 case 'n': return 0x253C;
+	 case 'o': return 0x23BA;
+	 case 'p': return 0x23BB;
+	 case 'r': return 0x23BC;
+	 case 's': return 0x23BD;
+	 case '0': return 0x2588;
+	 case 'a': return 0x2592;
+	 case 'h': return 0x2591;
+	 case '~': return 0x00B7;
+	 case '`': return 0x25C6;
+      }
+   }
+   if ((wc < ' ') || ((wc >= 0x7f) && (wc < 0xa0)) || (wc == WIDE_FILLER))
+      return '?';
+   return (Uint32) wc;
+}
+
+static void tty_put_char(TTY *t, Uint32 c)
+{
+   Uint8 utf8[ 4 ];
+
+   bytes_put( &t->buf, utf8, utf8_encode( c, utf8 ) );
+}
+
+static void color_param(char *p, int color, int base)
+{
+   if (color < 0)
+      sprintf( p, ";%d", base + 9 );
+   else if (color < 8)
+      sprintf( p, ";%d", base + color );
+   else if (color < 16)
+      sprintf( p, ";%d", base + 60 + color - 8 );
+   else
+      sprintf( p, ";%d;5;%d", base + 8, color );
+}
+
+/* the SGR parameters, each after a ';', that take the terminal from
+ * pen from to pen to */
+static void pen_params(char *p, Uint32 from, Uint32 to)
+{
+   static const struct { Uint32 bit; int on, off; } renditions[] = {
+      { PEN_BOLD, 1, 22 }, { PEN_DIM, 2, 22 }, { PEN_UNDERLINE, 4, 24 },
+      { PEN_BLINK, 5, 25 }, { PEN_REVERSE, 7, 27 }, { PEN_INVIS, 8, 28 }
+   };
+   Uint32 off = from & ~to;
+   int i;
+
+   *p = '\0';
+   /* 22 ends both bold and dim, so either may have to be set again */
+   if (off & (PEN_BOLD | PEN_DIM)) {
+      p += sprintf( p, ";22" );
+      from &= ~(PEN_BOLD | PEN_DIM);
+   }
+   for (i = 0; i < (int) (sizeof(renditions) / sizeof(renditions[0])); i++) {
+      if ((off & renditions[i].bit) && (renditions[i].off != 22))
+	 p += sprintf( p, ";%d", renditions[i].off );
+      if ((to & renditions[i].bit) && !(from & renditions[i].bit))
+	 p += sprintf( p, ";%d", renditions[i].on );
+   }
+   if (PEN_FG( from ) != PEN_FG( to )) {
+      color_param( p, PEN_FG( to ), 30 );
+      p += strlen( p );
+   }
+   if (PEN_BG( from ) != PEN_BG( to ))
+      color_param( p, PEN_BG( to ), 40 );
+}
+
+static void tty_set_pen(TTY *t, Uint32 pen)
+{
+   char delta[ 96 ], reset[ 96 ], seq[ 104 ];
+
+   if (pen == t->pen)
+      return;
+   pen_params( reset, 0, pen );
+   if (pen == 0)
+      strcpy( seq, "\033[m" );
+   else
+      sprintf( seq, "\033[0%sm", reset );
+   if (t->pen != TTY_UNKNOWN) {
+      pen_params( delta, t->pen, pen );
+      /* ESC [ and m around the parameters, less the first ';' */
+      if (strlen( delta ) + 2 < strlen( seq ))
+	 sprintf( seq, "\033[%sm", delta + 1 );
+   }
+   tty_puts( t, seq );
+   t->pen = pen;
+}
+
+/* whether the cursor can go right from column from to column to of
+ * row by printing the cells there again as they are */
+static bool can_reprint(TTY *t, int row, int from, int to)
+{
+   const MIRROR_CELL *cell = t->shown + row * t->cols + from;
+
+   for (; from < to; from++, cell++)
+      if ((cell->wc < ' ') || (cell->wc >= 0x7f) || (cell->attr != t->pen))
+	 return FALSE;
+   return TRUE;
+}
+
+/* move along row from column from to column to by the fewest bytes,
+ * returning how many; they are only sent if emit */
+static int tty_across(TTY *t, int row, int from, int to, bool emit)
+{
+   int cost, best, way, n = 0;
+
+   if (from == to)
+      return 0;
+   best = csi_cost( to + 1 );		/* CHA */
+   way = 'G';
+   if (to < from) {
+      n = from - to;
+      if (csi_cost( n ) < best) {
+	 best = csi_cost( n );
+	 way = 'D';
+      }
+      if (n < best) {
+	 best = n;
+	 way = '\b';
+      }
+   } else {
+      n = to - from;
+      if (csi_cost( n ) < best) {
+	 best = csi_cost( n );
+	 way = 'C';
+      }
+      if ((n < best) && can_reprint( t, row, from, to )) {
+	 best = n;
+	 way = 'r';
+      }
+   }
+   /* a carriage return, then right from the first column */
+   if (to == 0) {
+      cost = 1;
+   } else {
+      cost = 1 + csi_cost( to );
+      if ((1 + to < cost) && can_reprint( t, row, 0, to ))
+	 cost = 1 + to;
+   }
+   if (cost < best) {
+      best = cost;
+      way = '\r';
+   }
+   if (!emit)
+      return best;
+
+   switch (way) {
+      case 'G':
+	 tty_csi( t, to + 1, 'G' );
+	 break;
+      case 'D':
+      case 'C':
+	 tty_csi( t, n, (char) way );
+	 break;
+      case '\b':
+	 while (n-- > 0)
+	    bytes_byte( &t->buf, '\b' );
+	 break;
+      case 'r':
+	 for (; from < to; from++)
+	    bytes_byte( &t->buf, (int) t->shown[ row * t->cols + from ].wc );
+	 break;
+      case '\r':
+	 bytes_byte( &t->buf, '\r' );
+	 t->col = 0;
+	 tty_across( t, row, 0, to, TRUE );
+	 break;
+   }
+   return best;
+}
+
+/* move the cursor to row, col by the fewest bytes */
+static void tty_move(TTY *t, int row, int col)
+{
+   char seq[ 32 ];
+   int absolute, down, up, n;
+
+   if ((row == t->row) && (col == t->col))
+      return;
+   absolute = (col == 0) ? csi_cost( row + 1 ) : 4 + digits( row + 1 ) + digits( col + 1 );
+   if ((t->row >= 0) && (t->col >= 0)) {
+      n = (row > t->row) ? row - t->row : t->row - row;
+      /* line feeds go straight down, as output is not post-processed */
+      down = (n < csi_cost( n )) ? n : csi_cost( n );
+      up = (n == 0) ? 0 : csi_cost( n );
+      if (((row > t->row) ? down : up) + tty_across( t, row, t->col, col, FALSE ) <= absolute) {
+	 if ((row > t->row) && (n < csi_cost( n ))) {
+	    while (n-- > 0)
+	       bytes_byte( &t->buf, '\n' );
+	 } else if (row > t->row) {
+	    tty_csi( t, n, 'B' );
+	 } else if (row < t->row) {
+	    tty_csi( t, n, 'A' );
+	 }
+	 tty_across( t, row, t->col, col, TRUE );
+	 t->row = row;
+	 t->col = col;
+	 return;
+      }
+   }
+   if (col == 0)
+      tty_csi( t, row + 1, 'H' );
+   else {
+      sprintf( seq, "\033[%d;%dH", row + 1, col + 1 );
+      tty_puts( t, seq );
+   }
+   t->row = row;
+   t->col = col;
+}
+
+/* whether want[x] is the second half of the double-width character
+ * before it */
+static bool tty_filler(const MIRROR_CELL *want, int x)
+{
+   return (x > 0) && (want[x].wc == WIDE_FILLER) && (char_cells( want[ x - 1 ].wc ) == 2);
+}
+
+/* send the cells of row y that differ from what is shown */
+static void tty_row(TTY *t, int y)
+{
+   MIRROR_CELL *want = t->want + y * t->cols;
+   MIRROR_CELL *shown = t->shown + y * t->cols;
+   int x = t->first[y];
+   int last = t->last[y];
+   int sent = -1;		/* the end of the last cells sent */
+   int back = -1;		/* where the last step back was taken from */
+   int tail, changed, i, w;
+   Uint32 c, pen, blank_pen;
+
+   t->first[y] = t->last[y] = -1;
+
+   /* where the blanks the row ends in start, if erasing them pays */
+   blank_pen = tty_pen( want[ t->cols - 1 ].attr );
+   for (tail = t->cols; (tail > 0) && (want[ tail - 1 ].wc == ' ') &&
+	   (want[ tail - 1 ].attr == want[ t->cols - 1 ].attr); tail--)
+      ;
+   for (changed = 0, i = tail; i < t->cols; i++)
+      if ((shown[i].wc != ' ') || (shown[i].attr != blank_pen))
+	 changed++;
+   if ((changed < TTY_ERASE_MIN) || (blank_pen & ~(PEN_COLORS | PEN_BOLD)) ||
+       ((tail < t->cols) && (shown[tail].wc == WIDE_FILLER)))
+      tail = t->cols;
+
+   while (x <= last) {
+      if (x >= tail) {
+	 tty_move( t, y, x );
+	 tty_set_pen( t, blank_pen );
+	 tty_puts( t, "\033[K" );
+	 for (; x < t->cols; x++) {
+	    shown[x].wc = ' ';
+	    shown[x].attr = blank_pen;
+	 }
+	 break;
+      }
+
+      /* the second half of a double-width character is sent with
+       * it, so if it is not shown the whole character is sent again */
+      if (tty_filler( want, x )) {
+	 if ((shown[x].wc != WIDE_FILLER) && (sent != x) && (back != x)) {
+	    shown[ x - 1 ].wc = TTY_UNKNOWN;
+	    back = x;
+	    x--;
+	 } else {
+	    x++;
+	 }
+	 continue;
+      }
+      c = tty_char( want[x].wc, want[x].attr );
+      pen = tty_pen( want[x].attr );
+      if ((c == shown[x].wc) && (pen == shown[x].attr)) {
+	 x++;
+	 continue;
+      }
+      /* printing over half a double-width character spoils the other */
+      if ((shown[x].wc == WIDE_FILLER) && (x > 0) && (sent != x) && (back != x)) {
+	 shown[ x - 1 ].wc = TTY_UNKNOWN;
+	 back = x;
+	 x--;
+	 continue;
+      }
+      w = ((x + 1 < t->cols) && tty_filler( want, x + 1 )) ? 2 : 1;
+      if ((x + w < t->cols) && (shown[ x + w ].wc == WIDE_FILLER)) {
+	 shown[ x + w ].wc = TTY_UNKNOWN;
+	 if (last < x + w)
+	    last = x + w;
+      }
+
+      tty_move( t, y, x );
+      tty_set_pen( t, pen );
+      tty_put_char( t, c );
+      shown[x].wc = c;
+      shown[x].attr = pen;
+      if (w == 2) {
+	 shown[ x + 1 ].wc = WIDE_FILLER;
+	 shown[ x + 1 ].attr = pen;
+      }
+      x += w;
+      sent = x;
+      /* at the right margin the terminal may or may not have wrapped */
+      t->col = x;
+      if (x >= t->cols)
+	 t->row = t->col = -1;
+   }
+}
+
+static void tty_flush(TTY *t)
+{
+   size_t done = 0;
+   ssize_t n;
+   struct pollfd p;
+
+   while (done < t->buf.used) {
+      n = write( t->out, t->buf.data + done, t->buf.used - done );
+      if (n > 0) {
+	 done += n;
+      } else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+	 p.fd = t->out;
+	 p.events = POLLOUT;
+	 poll( &p, 1, -1 );
+      } else if ((n < 0) && (errno != EINTR)) {
+	 break;
+      }
+   }
+   t->buf.used = 0;
+}
+
+/* have the whole screen sent again, starting from a clear one */
+static void tty_clear(TTY *t)
+{
+   int i;
+
+   tty_puts( t, "\033[m\033[H\033[2J" );
+   t->pen = 0;
+   t->row = t->col = 0;
+   for (i = 0; i < t->lines * t->cols; i++) {
+      t->shown[i].wc = ' ';
+      t->shown[i].attr = 0;
+   }
+   for (i = 0; i < t->lines; i++) {
+      t->first[i] = 0;
+      t->last[i] = t->cols - 1;
+   }
+}
+
+/* put the terminal in the mode it is drawn in, on the alternate
+ * screen, and clear it */
+static void tty_enter(TTY *t)
+{
+   struct termios mode;
+
+   if (t->has_mode) {
+      mode = t->saved;
+      mode.c_iflag &= ~(ICRNL | INLCR | IGNCR | IXON | ISTRIP);
+      mode.c_oflag &= ~OPOST;
+      mode.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+      mode.c_cc[VMIN] = 1;
+      mode.c_cc[VTIME] = 0;
+      tcsetattr( t->in, TCSADRAIN, &mode );
+   }
+   t->raw = TRUE;
+   t->cursor_visibility = -1;
+   t->next_active = tty_active;
+   tty_active = t;
+   tty_puts( t, "\033[?1049h" );
+   tty_clear( t );
+}
+
+/* leave the terminal as it was found, for endwin */
+static void tty_leave(TTY *t)
+{
+   TTY **link;
+
+   if (!t->raw)
+      return;
+   tty_puts( t, "\033[m\033[?25h\033[?1049l" );
+   tty_flush( t );
+   if (t->has_mode)
+      tcsetattr( t->in, TCSADRAIN, &t->saved );
+   t->raw = FALSE;
+   for (link = &tty_active; *link != NULL; link = &(*link)->next_active)
+      if (*link == t) {
+	 *link = t->next_active;
+	 break;
+      }
+}
+
+static void tty_atexit(void)
+{
+   while (tty_active != NULL)
+      tty_leave( tty_active );
+}
+
+static void tty_sigwinch(int sig)
+{
+   tty_winched = 1;
+}
+
+/* the terminal's size, if it will say */
+static bool tty_winsize(TTY *t, int *lines, int *cols)
+{
+   struct winsize ws;
+
+   if ((ioctl( t->out, TIOCGWINSZ, &ws ) != 0) || (ws.ws_row == 0) || (ws.ws_col == 0))
+      return FALSE;
+   *lines = ws.ws_row;
+   *cols = ws.ws_col;
+   return TRUE;
+}
+
+/* make the copies lines by cols and send the screen again; FALSE if
+ * there is too little memory */
+static bool tty_size(TTY *t, int lines, int cols)
+{
+   size_t n = (size_t) lines * cols;
+   MIRROR_CELL *want, *shown;
+   int *first, *last;
+   int y;
+
+   want = malloc( n * sizeof(MIRROR_CELL) );
+   shown = malloc( n * sizeof(MIRROR_CELL) );
+   first = malloc( lines * sizeof(int) );
+   last = malloc( lines * sizeof(int) );
+   if ((want == NULL) || (shown == NULL) || (first == NULL) || (last == NULL)) {
+      free( want );
+      free( shown );
+      free( first );
+      free( last );
+      return FALSE;
+   }
+   blank_mirror_cells( want, n );
+   for (y = 0; (y < lines) && (y < t->lines); y++)
+      memcpy( want + y * cols, t->want + y * t->cols,
+	      ((cols < t->cols) ? cols : t->cols) * sizeof(MIRROR_CELL) );
+   free( t->want );
+   free( t->shown );
+   free( t->first );
+   free( t->last );
+   t->want = want;
+   t->shown = shown;
+   t->first = first;
+   t->last = last;
+   t->lines = lines;
+   t->cols = cols;
+   blank_mirror_cells( shown, n );
+   for (y = 0; y < lines; y++)
+      first[y] = last[y] = -1;
+   if (t->raw)
+      tty_clear( t );
+   return TRUE;
+}
+
+/* a terminal on out and in, or NULL */
+static TTY *tty_open(int out, int in)
+{
+   static bool handlers = FALSE;
+   struct sigaction action;
+   TTY *t;
+   int lines = SCREEN_CHAR_HEIGHT, cols = SCREEN_CHAR_WIDTH;
+
+   t = calloc( 1, sizeof(TTY) );
+   if (t == NULL)
+      return NULL;
+   t->out = out;
+   t->in = in;
+   t->pen = TTY_UNKNOWN;
+   t->row = t->col = -1;
+   t->has_mode = (tcgetattr( in, &t->saved ) == 0);
+   tty_winsize( t, &lines, &cols );
+   if (!tty_size( t, lines, cols )) {
+      free( t );
+      return NULL;
+   }
+   if (!handlers) {
+      memset( &action, 0, sizeof(action) );
+      action.sa_handler = tty_sigwinch;
+      sigemptyset( &action.sa_mask );
+      sigaction( SIGWINCH, &action, NULL );
+      atexit( tty_atexit );
+      handlers = TRUE;
+   }
+   tty_enter( t );
+   tty_flush( t );
+   return t;
+}
+
+static void tty_close(TTY *t)
+{
+   tty_leave( t );
+   free( t->want );
+   free( t->shown );
+   free( t->first );
+   free( t->last );
+   bytes_free( &t->buf );
+   free( t );
+}
+
+/* store columns x0..xend - 1 of row y of win in want */
+static void tty_span(TTY *t, WINDOW *win, int y, int x0, int xend)
+{
+   int row = win->y + y;
+   int col = win->x + x0;
+   MIRROR_CELL *cell;
+   wchar_t wc;
+   attr_t attrs;
+   int x;
+
+   if ((row < 0) || (row >= t->lines) || (col < 0) || (col >= t->cols))
+      return;
+   if (xend - x0 > t->cols - col)
+      xend = x0 + t->cols - col;
+   cell = t->want + row * t->cols + col;
+   for (x = x0; x < xend; x++, cell++, col++) {
+      wc = cell_char( win, y, x );
+      attrs = cell_attrib( win, y, x );
+      if ((cell->wc == (Uint32) wc) && (cell->attr == attrs))
+	 continue;
+      cell->wc = wc;
+      cell->attr = attrs;
+      if ((t->first[ row ] < 0) || (col < t->first[ row ]))
+	 t->first[ row ] = col;
+      if (col > t->last[ row ])
+	 t->last[ row ] = col;
+   }
+}
+
+/* send what a refresh changed, and the cursor, in one write */
+static void tty_frame_end(TTY *t)
+{
+   int y;
+
+   if (!t->raw)
+      return;
+   for (y = 0; y < t->lines; y++)
+      if (t->first[y] >= 0)
+	 tty_row( t, y );
+
+   if ((SP->cursor_visibility != 0) && (SP->cursor_row >= 0) && (SP->cursor_row < t->lines) &&
+       (SP->cursor_col >= 0) && (SP->cursor_col < t->cols))
+      tty_move( t, SP->cursor_row, SP->cursor_col );
+   if ((t->cursor_visibility < 0) || ((t->cursor_visibility != 0) != (SP->cursor_visibility != 0)))
+      tty_puts( t, (SP->cursor_visibility != 0) ? "\033[?25h" : "\033[?25l" );
+   t->cursor_visibility = SP->cursor_visibility;
+   tty_flush( t );
+}
+
+/* the palette has changed: every cell is compared again */
+static void tty_palette(TTY *t)
+{
+   int y;
+
+   for (y = 0; y < t->lines; y++) {
+      t->first[y] = 0;
+      t->last[y] = t->cols - 1;
+   }
+}
+
+#endif /* SDL_CURSES_TTY */
+
+/*
+ * refresh sinks
+ */
+
+/* hand the cells a refresh drew to the terminal, the recording, the
+ * mirror and the stream */
+static void sink_span(WINDOW *win, int y, int x0, int xend)
+{
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL)
+      tty_span( SP->tty, win, y, x0, xend );
+#endif
+   if (SP->record != NULL)
+      record_span( win, y, x0, xend );
+#ifdef SDL_CURSES_MIRROR
+   if (SP->mirror != NULL)
+      mirror_span( SP->mirror, win, y, x0, xend );
+#endif
+#ifdef SDL_CURSES_STREAM
+   if (SP->stream != NULL)
+      stream_span( SP->stream, win, y, x0, xend );
+#endif
+}
+
+/* a refresh is over */
+static void sink_frame_end(void)
+{
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL)
+      tty_frame_end( SP->tty );
+#endif
+   if (SP->record != NULL)
+      record_frame_end();
+#ifdef SDL_CURSES_MIRROR
+   if (SP->mirror != NULL)
+      mirror_end( SP->mirror );
+#endif
+#ifdef SDL_CURSES_STREAM
+   if (SP->stream != NULL)
+      stream_frame_end( SP->stream );
+#endif
+}
+
+/* the screen is now lines by cols */
+static void sink_resize(int lines, int cols)
+{
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL)
+      tty_size( SP->tty, lines, cols );
+#endif
+   if (SP->record != NULL) {
+      putc( 'S', SP->record );
+      put_varint( SP->record, lines );
+      put_varint( SP->record, cols );
+   }
+#ifdef SDL_CURSES_MIRROR
+   if ((SP->mirror != NULL) && mirror_size( SP->mirror, lines, cols ))
+      mirror_end( SP->mirror );
+#endif
+#ifdef SDL_CURSES_STREAM
+   if ((SP->stream != NULL) && !stream_size( SP->stream, lines, cols ))
+      streamcells( NULL );
+#endif
+}
+
+/* the palette has changed */
+static void sink_palette(void)
+{
+#ifdef SDL_CURSES_TTY
+   if ((SP != NULL) && (SP->tty != NULL))
+      tty_palette( SP->tty );
+#endif
+#ifdef SDL_CURSES_STREAM
+   if ((SP != NULL) && (SP->stream != NULL))
+      SP->stream->palette_due = TRUE;
+#endif
+}
+
+/* the screen is waiting for input */
+static void sink_idle(void)
+{
+#ifdef SDL_CURSES_STREAM
+   if ((SP != NULL) && (SP->stream != NULL))
+      stream_pump( SP->stream );
+#endif
+}
+
+/*
+ * glyph cache
+ */
+
+/* coverage masks, one byte per pixel, 0 being background and 255
+ * foreground, as wide as the cells the character takes.  Glyphs are
+ * built the first time they are drawn and cached by character and
+ * style.  The line-drawing set (GLYPH_ACS) is generated at the
+ * current cell size rather than taken from the font.  Bold
+ * (GLYPH_BOLD) is a glyph of its own, the plain one widened by a
+ * pixel, so that changing attributes never means changing the font's
+ * style.  Underlining is not a glyph style: the line is drawn over
+ * the cell as it is filled.
+ *
+ * The ASCII glyphs, which nearly everything uses, are kept in a
+ * table and never dropped.  The rest go into a hash table bounded
+ * to glyph_limit entries; when it is full the least recently drawn
+ * glyph makes way. */
+
+#define ARM_UP    (1)
+#define ARM_DOWN  (2)
+#define ARM_LEFT  (4)
+#define ARM_RIGHT (8)
+
+/* which arms of a line-drawing character reach the cell edges */
+static int acs_arms(unsigned char ch)
+{
+   switch (ch) {
+      case 'l': return ARM_DOWN | ARM_RIGHT;
+      case 'm': return ARM_UP | ARM_RIGHT;
+      case 'k': return ARM_DOWN | ARM_LEFT;
+      case 'j': return ARM_UP | ARM_LEFT;
+      case 't': return ARM_UP | ARM_DOWN | ARM_RIGHT;
+      case 'u': return ARM_UP | ARM_DOWN | ARM_LEFT;
+      case 'v': return ARM_UP | ARM_LEFT | ARM_RIGHT;
+      case 'w': return ARM_DOWN | ARM_LEFT | ARM_RIGHT;
+      case 'q': return ARM_LEFT | ARM_RIGHT;
+      case 'x': return ARM_UP | ARM_DOWN;
+      case 'n': return ARM_UP | ARM_DOWN | ARM_LEFT | ARM_RIGHT;
+   }
+   return 0;
+}
+
+/* alternate characters we generate a glyph for; the others in
+ * acs_map fall back to plain ASCII */
+static bool acs_is_drawn(unsigned char ch)
+{
+   return (acs_arms( ch ) != 0) || (strchr( "oprs0ah~`", ch ) != NULL);
+}
+
+static void mask_fill(Uint8 *mask, int x0, int y0, int x1, int y1)
+{
+   int x, y;
+
+   for (y = y0; y < y1; y++)
+      for (x = x0; x < x1; x++)
+	 mask[ y * display_char_width + x ] = 255;
+}
+
+static Uint8 *rasterize_acs_glyph(unsigned char ch)
+{
+   int w = display_char_width;
+   int h = display_char_height;
+   int t = (w >= 8) ? w / 8 : 1;      /* line thickness */
+   int mx = (w - t) / 2;
+   int my = (h - t) / 2;
+   int arms = acs_arms( ch );
+   int x, y;
+   Uint8 *mask;
+
+   mask = calloc( w * h, sizeof(Uint8) );
+   if (mask == NULL)
+      return NULL;
+
+   if (arms & ARM_LEFT)
+      mask_fill( mask, 0, my, mx + t, my + t );
+   if (arms & ARM_RIGHT)
+      mask_fill( mask, mx, my, w, my + t );
+   if (arms & ARM_UP)
+      mask_fill( mask, mx, 0, mx + t, my + t );
+   if (arms & ARM_DOWN)
+      mask_fill( mask, mx, my, mx + t, h );
+
+   switch (ch) {
+      case 'o': mask_fill( mask, 0, 0, w, t ); break;
+      case 'p': mask_fill( mask, 0, (h - t) / 4, w, (h - t) / 4 + t ); break;
+      case 'r': mask_fill( mask, 0, 3 * (h - t) / 4, w, 3 * (h - t) / 4 + t ); break;
+      case 's': mask_fill( mask, 0, h - t, w, h ); break;
+      case '0': mask_fill( mask, 0, 0, w, h ); break;
+      case 'a':
+	 for (y = 0; y < h; y++)
+	    for (x = 0; x < w; x++)
+	       mask[ y * w + x ] = ((x + y) & 1) ? 0 : 255;
+	 break;
+      case 'h':
+	 for (y = 0; y < h; y += 2)
+	    for (x = 0; x < w; x += 2)
+	       mask[ y * w + x ] = 255;
+	 break;
+      case '~':
+	 mask_fill( mask, (w - 2 * t) / 2, (h - 2 * t) / 2,
+		    (w + 2 * t) / 2, (h + 2 * t) / 2 );
+	 break;
+      case '`':
+	 for (y = 0; y < h; y++)
+	    for (x = 0; x < w; x++)
+	       if (10 * (abs( 2 * x + 1 - w ) * h + abs( 2 * y + 1 - h ) * w) <= 7 * w * h)
+		  mask[ y * w + x ] = 255;
+	 break;
+   }
+   return mask;
+}
+
+/* the built-in glyph showing wc, -1 if it has none */
+static int builtin_glyph(wchar_t wc)
+{
+   int i;
+
+   if ((Uint32) wc < 128)
+      return wc;
+   for (i = 1; i < 256; i++)
+      if (builtin_font_unicode[ i ] == wc)
+	 return i;
+   return -1;
+}
+
+/* a box, for characters the built-in font does not have */
+static Uint8 *rasterize_missing_glyph(wchar_t wc)
+{
+   int w = char_cells( wc ) * display_char_width;
+   int h = display_char_height;
+   int x, y;
+   Uint8 *mask;
+
+   mask = calloc( w * h, sizeof(Uint8) );
+   if (mask == NULL)
+      return NULL;
+   for (y = h / 8; y < h - h / 8; y++)
+      for (x = 1; x < w - 2; x++)
+	 if ((y == h / 8) || (y == h - h / 8 - 1) || (x == 1) || (x == w - 3))
+	    mask[ y * w + x ] = 255;
+   return mask;
+}
+
+/* usefont's font, NULL if it will not open; the styles are drawn
+ * from its plain glyphs, so it is set to render those once here */
+static TTF_Font *open_font(void)
+{
+   TTF_Font *font = TTF_OpenFont( font_file, font_points );
+
+   if (font != NULL)
+      TTF_SetFontStyle( font, TTF_STYLE_NORMAL );
+   return font;
+}
+
+static Uint8 *rasterize_font_glyph(TTF_Font *font, wchar_t wc)
+{
+   SDL_Color white = { 255, 255, 255, 0 };
+   SDL_Color black = { 0, 0, 0, 0 };
+   int w = char_cells( wc ) * display_char_width;
+   SDL_Surface *temp;
+   Uint8 *mask;
+   int x, y;
+
+   if (font == NULL)
+      return rasterize_missing_glyph( wc );
+
+   mask = calloc( w * display_char_height, sizeof(Uint8) );
+   if ((mask == NULL) || (wc == '\0') || (wc == ' '))
+      return mask;
+
+   /* the font is addressed in UCS-2; the other planes show as the
+    * replacement character */
+   temp = TTF_RenderGlyph_Shaded( font, (Uint16) ((wc > 0xFFFF) ? 0xFFFD : wc),
+				  white, black );
+   if (temp == NULL) {
+      free( mask );
+      return NULL;
+   }
+
+   /* shaded text is 8 bit, with the pixel value giving the coverage */
+   SDL_LockSurface( temp );
+   for (y = 0; (y < temp->h) && (y < (int) display_char_height); y++)
+      for (x = 0; (x < temp->w) && (x < w); x++)
+	 mask[ y * w + x ] = ((Uint8 *) temp->pixels)[ y * temp->pitch + x ];
+   SDL_UnlockSurface( temp );
+   SDL_FreeSurface( temp );
+   return mask;
+}
+
+/* thicken a mask w pixels wide by a pixel to the right */
+static void embolden_mask(Uint8 *mask, int w)
+{
+   int x, y;
+   Uint8 *row;
+
+   for (y = 0, row = mask; y < (int) display_char_height; y++, row += w)
+      for (x = w - 1; x > 0; x--)
+	 if (row[ x - 1 ] > row[ x ])
+	    row[ x ] = row[ x - 1 ];
+}
+
+/* the glyph for wc in a style, using font for the font glyphs */
+static Uint8 *rasterize_glyph(TTF_Font *font, wchar_t wc, int style)
+{
+   Uint8 *mask;
+
+   if (style & GLYPH_ACS)
+      mask = rasterize_acs_glyph( (unsigned char) wc );
+   else
+      mask = rasterize_font_glyph( font, wc );
+   if ((mask != NULL) && (style & GLYPH_BOLD))
+      embolden_mask( mask, ((style & GLYPH_ACS) ? 1 : char_cells( wc )) * display_char_width );
+   return mask;
+}
+
+static unsigned int glyph_hash(Uint32 key)
+{
+   return (key * 2654435761U) >> 21;	/* top 11 bits: GLYPH_BUCKETS */
+}
+
+static void glyph_unlink(GLYPH *glyph)
+{
+   if (glyph->newer != NULL)
+      glyph->newer->older = glyph->older;
+   else
+      SP->glyph_newest = glyph->older;
+   if (glyph->older != NULL)
+      glyph->older->newer = glyph->newer;
+   else
+      SP->glyph_oldest = glyph->newer;
+}
+
+static void glyph_link_newest(GLYPH *glyph)
+{
+   glyph->newer = NULL;
+   glyph->older = SP->glyph_newest;
+   if (SP->glyph_newest != NULL)
+      SP->glyph_newest->newer = glyph;
+   else
+      SP->glyph_oldest = glyph;
+   SP->glyph_newest = glyph;
+}
+
+/* drop the least recently drawn glyph */
+static void glyph_evict(void)
+{
+   GLYPH *victim = SP->glyph_oldest;
+   GLYPH **link;
+
+   if (victim == NULL)
+      return;
+   glyph_unlink( victim );
+   for (link = &SP->glyph_buckets[ glyph_hash( victim->key ) ]; *link != NULL; link = &(*link)->chain) {
+      if (*link == victim) {
+	 *link = victim->chain;
+	 break;
+      }
+   }
+   free( victim->mask );
+   free( victim );
+   SP->glyph_count--;
+}
+
+/* the GLYPH_ style a character with these attributes is drawn in */
+static int glyph_style(wchar_t wc, attr_t attrib)
+{
+   int style = 0;
+
+   if ((wc < 128) && ALTCHARSET( attrib ) && acs_is_drawn( (unsigned char) wc ))
+      style |= GLYPH_ACS;
+   if (BOLD( attrib ))
+      style |= GLYPH_BOLD;
+   return style;
+}
+
+/* the coverage mask for a cell, NULL if it could not be built */
+static const Uint8 *get_glyph(wchar_t wc, attr_t attrib)
+{
+   int style = glyph_style( wc, attrib );
+   Uint32 key;
+   GLYPH *glyph;
+   GLYPH **bucket;
+
+   if ((Uint32) wc < 128) {
+      if (SP->glyph_ascii[ style ][ wc ] == NULL)
+	 SP->glyph_ascii[ style ][ wc ] = rasterize_glyph( g_term_font, wc, style );
+      return SP->glyph_ascii[ style ][ wc ];
+   }
+
+   key = ((Uint32) wc << 4) | style;
+   bucket = &SP->glyph_buckets[ glyph_hash( key ) ];
+   for (glyph = *bucket; glyph != NULL; glyph = glyph->chain) {
+      if (glyph->key == key) {
+	 if (glyph != SP->glyph_newest) {
+	    glyph_unlink( glyph );
+	    glyph_link_newest( glyph );
+	 }
+	 return glyph->mask;
+      }
+   }
+
+   glyph = malloc( sizeof(GLYPH) );
+   if (glyph == NULL)
+      return NULL;
+   glyph->mask = rasterize_glyph( g_term_font, wc, style );
+   if (glyph->mask == NULL) {
+      free( glyph );
+      return NULL;
+   }
+   while (SP->glyph_count >= SP->glyph_limit)
+      glyph_evict();
+   glyph->key = key;
+   glyph->chain = *bucket;
+   *bucket = glyph;
+   glyph_link_newest( glyph );
+   SP->glyph_count++;
+   return glyph->mask;
+}
+
+
+/*
+ * glyph atlas
+ */
+
+/* With a font from usefont, the pinned ASCII glyphs of every style in
+ * atlas_styles are built together at initscr: the atlas.  Where the
+ * system allows, the atlas is kept in a cache file named after a hash
+ * of the font's path, modification time and point size, the cell
+ * size and the styles, and later runs map that file in instead of
+ * rasterizing.  The file is a header followed by the masks, style by
+ * style and character by character. */
+#define ATLAS_MAGIC   (0x54414353)	/* "SCAT" */
+#define ATLAS_VERSION (1)
+#define ATLAS_CHARS   (128)
+
+typedef struct s_AtlasHeader
+{
+      Uint32 magic;
+      Uint32 version;
+      Uint64 key;
+      Uint32 char_width;
+      Uint32 char_height;
+      Uint32 styles;
+      Uint32 chars;
+} ATLAS_HEADER;
+
+static const int atlas_styles[] = { 0, GLYPH_BOLD };
+#define ATLAS_STYLES ((int) (sizeof(atlas_styles) / sizeof(atlas_styles[0])))
+
+/* A cold atlas is rasterized by up to ATLAS_WORKERS_MAX threads, each
+ * taking a contiguous run of the glyphs with its own TTF_Font, as
+ * SDL_ttf fonts may not be shared between threads.  The workers fill
+ * a private table; once all have been joined it is published into
+ * glyph_ascii in one go, so drawing never sees a half-built atlas. */
+#define ATLAS_WORKERS_MAX (8)
+
+typedef struct s_AtlasWorker
+{
+      TTF_Font *font;
+      int first, last;		/* the glyphs, as style * ATLAS_CHARS + ch */
+      Uint8 **masks;
+      unsigned int char_width, char_height;
+      SDL_Thread *thread;
+} ATLAS_WORKER;
+
+static int atlas_threads = 0;	/* 0 for one per processor */
+
+/* 64 bit FNV-1a */
+static void atlas_hash(Uint64 *hash, const void *data, size_t len)
+{
+   const Uint8 *p = data;
+
+   while (len-- > 0) {
+      *hash ^= *p++;
+      *hash *= 0x100000001b3ULL;
+   }
+}
+
+static Uint64 atlas_key(void)
+{
+   Uint64 key = 0xcbf29ce484222325ULL;
+   Uint32 fields[ 5 ];
+
+   atlas_hash( &key, font_file, strlen( font_file ) + 1 );
+#ifdef SDL_CURSES_POSIX
+   {
+      struct stat st;
+
+      if (stat( font_file, &st ) == 0)
+	 atlas_hash( &key, &st.st_mtime, sizeof(st.st_mtime) );
+   }
+#endif
+   fields[0] = font_points;
+   fields[1] = display_char_width;
+   fields[2] = display_char_height;
+   fields[3] = ATLAS_VERSION;
+   fields[4] = ATLAS_STYLES;
+   atlas_hash( &key, fields, sizeof(fields) );
+   atlas_hash( &key, atlas_styles, sizeof(atlas_styles) );
+   return key;
+}
+
+static size_t atlas_mask_size(void)
+{
+   return display_char_width * display_char_height;
+}
+
+#ifdef SDL_CURSES_POSIX
+
+/* where the cache file for key lives, FALSE if there is nowhere:
+ * in $SDLCURSES_CACHE, or else ~/.sdlcurses, made if it is not there */
+static bool atlas_path(Uint64 key, char *path, size_t size)
+{
+   char dir[ 1024 ];
+   const char *home;
+
+   if (getenv( "SDLCURSES_CACHE" ) != NULL) {
+      if ((size_t) snprintf( dir, sizeof(dir), "%s", getenv( "SDLCURSES_CACHE" ) ) >= sizeof(dir))
+	 return FALSE;
+   } else {
+      home = getenv( "HOME" );
+      if ((home == NULL) ||
+	  ((size_t) snprintf( dir, sizeof(dir), "%s/.sdlcurses", home ) >= sizeof(dir)))
+	 return FALSE;
+   }
+   mkdir( dir, 0700 );
+   return (size_t) snprintf( path, size, "%s/%08lx%08lx.atlas", dir,
+			     (unsigned long) (key >> 32),
+			     (unsigned long) (key & 0xffffffff) ) < size;
+}
+
+/* map the cache file for key and point the pinned glyphs into it */
+static bool atlas_load(Uint64 key)
+{
+   char path[ 1024 ];
+   const ATLAS_HEADER *header;
+   const Uint8 *masks;
+   size_t size = sizeof(ATLAS_HEADER) + ATLAS_STYLES * ATLAS_CHARS * atlas_mask_size();
+   struct stat st;
+   void *map;
+   int fd, i, ch;
+
+   if (!atlas_path( key, path, sizeof(path) ))
+      return FALSE;
+   fd = open( path, O_RDONLY );
+   if (fd < 0)
+      return FALSE;
+   if ((fstat( fd, &st ) < 0) || ((size_t) st.st_size != size)) {
+      close( fd );
+      return FALSE;
+   }
+   map = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+   close( fd );
+   if (map == MAP_FAILED)
+      return FALSE;
+
+   header = map;
+   if ((header->magic != ATLAS_MAGIC) || (header->version != ATLAS_VERSION) ||
+       (header->key != key) ||
+       (header->char_width != display_char_width) ||
+       (header->char_height != display_char_height) ||
+       (header->styles != (Uint32) ATLAS_STYLES) || (header->chars != ATLAS_CHARS)) {
+      munmap( map, size );
+      return FALSE;
+   }
+
+   masks = (const Uint8 *) (header + 1);
+   for (i = 0; i < ATLAS_STYLES; i++)
+      for (ch = 0; ch < ATLAS_CHARS; ch++, masks += atlas_mask_size())
+	 SP->glyph_ascii[ atlas_styles[i] ][ ch ] = (Uint8 *) masks;
+   SP->atlas_map = map;
+   SP->atlas_map_size = size;
+   return TRUE;
+}
+
+/* write the built atlas to the cache file for key; written under a
+ * temporary name and renamed, so a reader never sees half a file */
+static void atlas_save(Uint64 key)
+{
+   char path[ 1024 ];
+   char temp[ 1040 ];
+   ATLAS_HEADER header;
+   FILE *file;
+   int i, ch;
+   bool ok;
+
+   if (!atlas_path( key, path, sizeof(path) ))
+      return;
+   snprintf( temp, sizeof(temp), "%s.%ld", path, (long) getpid() );
+   file = fopen( temp, "wb" );
+   if (file == NULL)
+      return;
+
+   header.magic = ATLAS_MAGIC;
+   header.version = ATLAS_VERSION;
+   header.key = key;
+   header.char_width = display_char_width;
+   header.char_height = display_char_height;
+   header.styles = ATLAS_STYLES;
+   header.chars = ATLAS_CHARS;
+   ok = (fwrite( &header, sizeof(header), 1, file ) == 1);
+   for (i = 0; ok && (i < ATLAS_STYLES); i++)
+      for (ch = 0; ok && (ch < ATLAS_CHARS); ch++)
+	 ok = (fwrite( SP->glyph_ascii[ atlas_styles[i] ][ ch ], atlas_mask_size(), 1, file ) == 1);
+   if ((fclose( file ) != 0) || !ok || (rename( temp, path ) != 0))
+      remove( temp );
+}
+
+#else
+
+static bool atlas_load(Uint64 key)
+{
+   return FALSE;
+}
+
+static void atlas_save(Uint64 key)
+{
+}
+
+#endif /* SDL_CURSES_POSIX */
+
+static int atlas_worker(void *data)
+{
+   ATLAS_WORKER *worker = data;
+   int glyph;
+
+   /* the cell size is per thread: take on the caller's */
+   display_char_width = worker->char_width;
+   display_char_height = worker->char_height;
+   for (glyph = worker->first; glyph < worker->last; glyph++)
+      worker->masks[ glyph ] = rasterize_glyph( worker->font, glyph % ATLAS_CHARS,
+						atlas_styles[ glyph / ATLAS_CHARS ] );
+   return 0;
+}
+
+static int atlas_worker_count(void)
+{
+   int n = atlas_threads;
+
+#ifdef SDL_CURSES_POSIX
+   if (n == 0)
+      n = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+   if (n < 1)
+      n = 1;
+   if (n > ATLAS_WORKERS_MAX)
+      n = ATLAS_WORKERS_MAX;
+   return n;
+}
+
+/* rasterize the atlas, FALSE if any glyph failed */
+static bool atlas_build(void)
+{
+   ATLAS_WORKER workers[ ATLAS_WORKERS_MAX ];
+   int glyphs = ATLAS_STYLES * ATLAS_CHARS;
+   int nworkers = atlas_worker_count();
+   Uint8 **masks;
+   Uint8 **slot;
+   int i;
+   bool ok = TRUE;
+
+   masks = calloc( glyphs, sizeof(Uint8 *) );
+   if (masks == NULL)
+      return FALSE;
+
+   /* the fonts are opened here: FreeType does not allow faces to be
+    * opened on one library from several threads at once */
+   for (i = 0; i < nworkers; i++) {
+      workers[i].font = (i == 0) ? g_term_font : open_font();
+      workers[i].first = glyphs * i / nworkers;
+      workers[i].last = glyphs * (i + 1) / nworkers;
+      workers[i].masks = masks;
+      workers[i].char_width = display_char_width;
+      workers[i].char_height = display_char_height;
+      workers[i].thread = NULL;
+   }
+   for (i = 1; i < nworkers; i++)
+      if (workers[i].font != NULL)
+	 workers[i].thread = SDL_CreateThread( atlas_worker, &workers[i] );
+
+   /* this thread does the first run itself, and the run of any worker
+    * that could not be started, with the worker's font if it has one */
+   atlas_worker( &workers[0] );
+   for (i = 1; i < nworkers; i++) {
+      if (workers[i].thread != NULL)
+	 SDL_WaitThread( workers[i].thread, NULL );
+      else {
+	 if (workers[i].font == NULL)
+	    workers[i].font = g_term_font;
+	 atlas_worker( &workers[i] );
+      }
+   }
+   for (i = 1; i < nworkers; i++)
+      if (workers[i].font != g_term_font)
+	 TTF_CloseFont( workers[i].font );
+
+   /* publish */
+   for (i = 0; i < glyphs; i++) {
+      slot = &SP->glyph_ascii[ atlas_styles[ i / ATLAS_CHARS ] ][ i % ATLAS_CHARS ];
+      if (*slot == NULL)
+	 *slot = masks[i];
+      else
+	 free( masks[i] );
+      if (*slot == NULL)
+	 ok = FALSE;
+   }
+   free( masks );
+   return ok;
+}
+
+/* have the atlas ready before the first frame: from the cache file
+ * if there is one for this font, otherwise built and saved */
+static void init_atlas(void)
+{
+   Uint64 key;
+
+   if (g_term_font == NULL)
+      return;
+   key = atlas_key();
+   if (atlas_load( key ))
+      return;
+   if (atlas_build())
+      atlas_save( key );
+}
+
+#define BRIGHTEN(c) ((Uint8) (((c) >= 128) ? 255 : (c) << 1))
+
+/* the colours a cell with these attributes is drawn in */
+static void cell_colors(attr_t attrib, SDL_Color *fgp, SDL_Color *bgp)
+{
+   SDL_Color fg, bg;
+
+   if (!REVERSE( attrib )) { 
+      fg = color_pots[ FG( PAIR_NUMBER( attrib ) ) ];
+      bg = color_pots[ BG( PAIR_NUMBER( attrib ) ) ]; 
+   } else {
+      bg = color_pots[ FG( PAIR_NUMBER( attrib ) ) ];
+      fg = color_pots[ BG( PAIR_NUMBER( attrib ) ) ]; 
+   }
+
+   if (DIM(attrib)) {
+      fg.r = fg.r >> 1;	 fg.b = fg.b >> 1;	 fg.g = fg.g >> 1;
+      bg.r = bg.r >> 1;	 bg.b = bg.b >> 1;	 bg.g = bg.g >> 1;
+   }
+
+   /* doubled, but saturating rather than wrapping; bold is drawn
+      with a bold glyph and leaves the colours alone */
+   if (STANDOUT(attrib)) {
+      fg.r = BRIGHTEN( fg.r );	    fg.b = BRIGHTEN( fg.b );	    fg.g = BRIGHTEN( fg.g );
+      bg.r = BRIGHTEN( bg.r );	    bg.b = BRIGHTEN( bg.b );	    bg.g = BRIGHTEN( bg.g );
+   }
+
+   *fgp = fg;
+   *bgp = bg;
+}
+
+static void put_pixel(Uint8 *p, int bpp, Uint32 pixel)
+{
+   switch (bpp) {
+      case 1:
+	 *p = pixel;
+	 break;
+      case 2:
+	 *(Uint16 *) p = pixel;
+	 break;
+      case 3:
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	 p[0] = (pixel >> 16) & 0xff;
+	 p[1] = (pixel >> 8) & 0xff;
+	 p[2] = pixel & 0xff;
+#else
+	 p[0] = pixel & 0xff;
+	 p[1] = (pixel >> 8) & 0xff;
+	 p[2] = (pixel >> 16) & 0xff;
+#endif
+	 break;
+      case 4:
+	 *(Uint32 *) p = pixel;
+	 break;
+   }
+}
+
+/* draw w pixels' width of a glyph whose mask is mask_w wide at pixel
+ * position px, py of the locked surface, underlined if asked; a NULL
+ * mask draws the background only */
+static void draw_glyph(SDL_Surface *surface, int px, int py, const Uint8 *mask,
+		       int mask_w, int w, bool underline, SDL_Color fg, SDL_Color bg)
+{
+   int bpp = surface->format->BytesPerPixel;
+   Uint32 fgpix = SDL_MapRGB( surface->format, fg.r, fg.g, fg.b );
+   Uint32 bgpix = SDL_MapRGB( surface->format, bg.r, bg.g, bg.b );
+   Uint8 *row;
+   int x, y, cover;
+
+   if ((px < 0) || (py < 0) ||
+       (px + w > surface->w) ||
+       (py + (int) display_char_height > surface->h))
+      return;
+
+   row = (Uint8 *) surface->pixels + py * surface->pitch + px * bpp;
+   for (y = 0; y < (int) display_char_height; y++, row += surface->pitch) {
+      if (underline && (y == SP->underline_row)) {
+	 for (x = 0; x < w; x++)
+	    put_pixel( row + x * bpp, bpp, fgpix );
+	 continue;
+      }
+      for (x = 0; x < w; x++) {
+	 cover = (mask != NULL) ? mask[ y * mask_w + x ] : 0;
+	 if (cover == 0)
+	    put_pixel( row + x * bpp, bpp, bgpix );
+	 else if (cover == 255)
+	    put_pixel( row + x * bpp, bpp, fgpix );
+	 else
+	    put_pixel( row + x * bpp, bpp,
+		       SDL_MapRGB( surface->format,
+				   bg.r + ((fg.r - bg.r) * cover) / 255,
+				   bg.g + ((fg.g - bg.g) * cover) / 255,
+				   bg.b + ((fg.b - bg.b) * cover) / 255 ) );
+      }
+   }
+}
+
+/* draw a built-in glyph at pixel position px, py of the locked
+ * surface straight from its bitmap rows, emboldened by or-ing each
+ * row with itself shifted a pixel right */
+static void draw_bitmap_glyph(SDL_Surface *surface, int px, int py, const Uint16 *rows,
+			      bool bold, bool underline, SDL_Color fg, SDL_Color bg)
+{
+   int bpp = surface->format->BytesPerPixel;
+   Uint32 fgpix = SDL_MapRGB( surface->format, fg.r, fg.g, fg.b );
+   Uint32 bgpix = SDL_MapRGB( surface->format, bg.r, bg.g, bg.b );
+   Uint8 *row;
+   Uint16 bits;
+   int x, y;
+
+   if ((px < 0) || (py < 0) ||
+       (px + BUILTIN_FONT_WIDTH > surface->w) ||
+       (py + BUILTIN_FONT_HEIGHT > surface->h))
+      return;
+
+   row = (Uint8 *) surface->pixels + py * surface->pitch + px * bpp;
+   for (y = 0; y < BUILTIN_FONT_HEIGHT; y++, row += surface->pitch) {
+      bits = rows[ y ];
+      if (bold)
+	 bits |= bits >> 1;
+      if (underline && (y == SP->underline_row))
+	 bits = 0xFFFF;
+      for (x = 0; x < BUILTIN_FONT_WIDTH; x++, bits <<= 1)
+	 put_pixel( row + x * bpp, bpp, (bits & 0x8000) ? fgpix : bgpix );
+   }
+}
+
+
+/*
+ * window arrays
+ */
+
+/* the bytes the arrays of a height by width window take; a
+ * compressed window has row pointers in place of cells */
+static size_t cells_size(int height, int width, bool packed)
+{
+   size_t size = 2 * POOL_ALIGN( height * sizeof(void *) ) +
+      2 * POOL_ALIGN( height * sizeof(int) ) +
+      POOL_ALIGN( height * sizeof(bool) );
+
+   if (packed)
+      return size + POOL_ALIGN( height * sizeof(RUNS *) );
+   return size + POOL_ALIGN( height * width * sizeof(wchar_t) ) +
+      POOL_ALIGN( height * width * sizeof(attr_t) );
+}
+
+/* point win's arrays into mem for a height by width window, the text
+ * blank, the attributes and blinking rows clear and the change
+ * tracking unset */
+static void lay_out_cells(WINDOW *win, void *mem, int height, int width, bool packed)
+{
+   Uint8 *p = mem;
+   int row;
+
+   win->lines = (wchar_t **) p;
+   p += POOL_ALIGN( height * sizeof(void *) );
+   win->alines = (attr_t **) p;
+   p += POOL_ALIGN( height * sizeof(void *) );
+   win->firstch = (int *) p;
+   p += POOL_ALIGN( height * sizeof(int) );
+   win->lastch = (int *) p;
+   p += POOL_ALIGN( height * sizeof(int) );
+   win->blinkrows = (bool *) p;
+   p += POOL_ALIGN( height * sizeof(bool) );
+   memset( win->blinkrows, 0, height * sizeof(bool) );
+   for (row = 0; row < height; row++) {
+      win->firstch[row] = _NOCHANGE;
+      win->lastch[row] = _NOCHANGE;
+   }
+
+   /* the rows of a compressed window start out blank */
+   if (packed) {
+      win->runs = (RUNS **) p;
+      win->text = NULL;
+      win->attrib = NULL;
+      for (row = 0; row < height; row++) {
+	 win->lines[row] = NULL;
+	 win->alines[row] = NULL;
+	 win->runs[row] = NULL;
+      }
+      return;
+   }
+
+   win->runs = NULL;
+   win->text = (wchar_t *) p;
+   p += POOL_ALIGN( height * width * sizeof(wchar_t) );
+   win->attrib = (attr_t *) p;
+   wmemset( win->text, ' ', width * height );
+   memset( win->attrib, 0, width * height * sizeof(attr_t) );
+   for (row = 0; row < height; row++) {
+      win->lines[row] = win->text + row * width;
+      win->alines[row] = win->attrib + row * width;
+   }
+}
+
+/*
+  windowstats reports the current screen's live windows and the bytes
+  its window pool holds, handed out or free, for debugging.  Either
+  pointer may be NULL.
+*/
+int windowstats(int *live, unsigned long *pool_bytes)
+{
+   if (SP == NULL)
+      return ERR;
+   if (live != NULL)
+      *live = SP->live_windows;
+   if (pool_bytes != NULL)
+      *pool_bytes = SP->pool_bytes;
+   return OK;
+}
+
+
+/***********************************
+ *** Window Manipulation Routines ***
+ ***********************************/
+
+/*
+  Calling newwin creates and returns a pointer to a new window
+  with the given number of lines and columns.  The upper
+  left-hand corner of the window is at line begin_y, column
+  begin_x.  If either nlines or ncols is zero, they default to
+  LINES - begin_y and COLS - begin_x.  A new full-screen window
+  is created by calling newwin(0,0,0,0).  * Create a new window
+  of the given dimensions at a given position
+*/
+
+WINDOW *newwin( int height, int  width, int ypos, int xpos )
+{
+   WINDOW * newwinptr;
+
+   if (SP == NULL)
+      return NULL;
+
+   /* the window and its arrays are allocated as one */
+   newwinptr = pool_alloc( POOL_ALIGN( sizeof(WINDOW) ) +
+			   cells_size( height, width, SP->pack_new ) );
+   if ( newwinptr == NULL ) {
+      return ( NULL );
+   }
+
+   /* set up data members of window */
+   newwinptr->x = xpos;
+   newwinptr->y = ypos;
+   newwinptr->cx = 0;
+   newwinptr->cy = 0;
+   newwinptr->width = width;
+   newwinptr->height = height;
+   newwinptr->delay = -1;
+   newwinptr->keypad_on = FALSE;
+   newwinptr->leaveok = FALSE;
+   newwinptr->attributes = 0;
+   newwinptr->cells = NULL;
+   newwinptr->backing = NULL;
+   lay_out_cells( newwinptr, (Uint8 *) newwinptr + POOL_ALIGN( sizeof(WINDOW) ),
+		  height, width, SP->pack_new );
+
+   newwinptr->next = SP->windows;
+   SP->windows = newwinptr;
+   SP->live_windows++;
+
+   /* a new window has never been drawn */
+   touchwin( newwinptr );
+   return newwinptr;
+}
+
+/* copy the exported globals into sp, or back out of it */
+static void save_globals(SCREEN *sp)
+{
+   sp->screen = screen;
+   sp->font = g_term_font;
+   sp->stdscr = stdscr;
+   sp->curscr = curscr;
+   sp->echo_on = echo_on;
+   sp->cbreak_on = cbreak_on;
+   sp->halfdelay_tenths = halfdelay_tenths;
+   sp->screen_width = screen_width;
+   sp->screen_height = screen_height;
+   sp->char_height = display_char_height;
+   sp->char_width = display_char_width;
+   sp->lines = LINES;
+   sp->cols = COLS;
+   memcpy( sp->color_pots, color_pots, sizeof(color_pots) );
+   memcpy( sp->color_pairs, color_pairs, sizeof(color_pairs) );
+}
+
+static void load_globals(const SCREEN *sp)
+{
+   screen = sp->screen;
+   g_term_font = sp->font;
+   stdscr = sp->stdscr;
+   curscr = sp->curscr;
+   echo_on = sp->echo_on;
+   cbreak_on = sp->cbreak_on;
+   halfdelay_tenths = sp->halfdelay_tenths;
+   screen_width = sp->screen_width;
+   screen_height = sp->screen_height;
+   display_char_height = sp->char_height;
+   display_char_width = sp->char_width;
+   LINES = sp->lines;
+   COLS = sp->cols;
+   memcpy( color_pots, sp->color_pots, sizeof(color_pots) );
+   memcpy( color_pairs, sp->color_pairs, sizeof(color_pairs) );
+}
+
+/* the globals of the current screen changed: copy them into it at
+ * once, not only when another is made current, so that term_surface
+ * and a thread that takes the screen over never see them stale */
+static void globals_changed(void)
+{
+   if (SP != NULL)
+      save_globals( SP );
+}
+
+/* an offscreen surface the size given in the format of like */
+static SDL_Surface *like_surface(SDL_Surface *like, int w, int h)
+{
+   SDL_Surface *surface;
+
+   surface = SDL_CreateRGBSurface( SDL_SWSURFACE, w, h, like->format->BitsPerPixel,
+				   like->format->Rmask, like->format->Gmask,
+				   like->format->Bmask, like->format->Amask );
+   if ((surface != NULL) && (like->format->palette != NULL))
+      SDL_SetColors( surface, like->format->palette->colors, 0,
+		     like->format->palette->ncolors );
+   return surface;
+}
+
+/* open the display for the current screen, drawing on an offscreen
+ * surface when it is scaled up */
+static bool open_display(void)
+{
+   SP->video = SDL_SetVideoMode( screen_width * SP->scale_factor,
+				 screen_height * SP->scale_factor, 0, SDL_RESIZABLE );
+   if (SP->video == NULL)
+      return FALSE;
+   screen = SP->video;
+   if (SP->scale_factor > 1)
+      screen = like_surface( SP->video, screen_width, screen_height );
+   if (screen == NULL)
+      return FALSE;
+
+   SDL_WM_SetCaption("Omega", NULL);
+
+   /* ignore events we can't possibly use */
+   SDL_EventState( SDL_IGNORE, SDL_MOUSEMOTION );
+   SDL_EventState( SDL_IGNORE, SDL_JOYBALLMOTION );
+   SDL_EventState( SDL_IGNORE, SDL_JOYHATMOTION );
+   SDL_EnableKeyRepeat( key_repeat_delay, key_repeat_interval );
+   return TRUE;
+}
+
+/* a screen with the defaults, made current */
+static SCREEN *new_screen(void)
+{
+   SCREEN *sp;
+
+   sp = calloc( 1, sizeof(SCREEN) );
+   if (sp == NULL)
+      return NULL;
+   sp->display = (display_screen == NULL);
+   sp->scale_factor = sp->display ? scale_request : 1;
+   sp->typeahead_fd = -1;
+   sp->blink_visible = TRUE;
+   sp->glyph_limit = GLYPH_LIMIT;
+   sp->cursor_visibility = 1;
+   sp->queue_head = &sp->queue_stub;
+   sp->queue_tail = &sp->queue_stub;
+   sp->backing_limit = BACKING_LIMIT;
+   sp->lines = SCREEN_CHAR_HEIGHT;
+   sp->cols = SCREEN_CHAR_WIDTH;
+   sp->echo_on = TRUE;
+   sp->cbreak_on = FALSE;
+   memcpy( sp->color_pots, default_pots, sizeof(default_pots) );
+   set_term( sp );
+   return sp;
+}
+
+/* undo a newterm that got as far as making sp, giving the thread back
+ * the screen it had; returns NULL for newterm to return */
+static SCREEN *newterm_failed(SCREEN *sp, SCREEN *previous)
+{
+   delscreen( sp );
+   set_term( previous );
+   return NULL;
+}
+
+/* newterm for a screen on the terminal outfd, read from infd; it has
+ * no surface, and its cells are a pixel each so that the measures of
+ * the screen are in cells */
+static SCREEN *tty_newterm(FILE *outfd, FILE *infd)
+{
+#ifdef SDL_CURSES_TTY
+   SCREEN *previous = SP;
+   SCREEN *sp;
+   TTY *t;
+
+   if ((outfd == NULL) || (infd == NULL))
+      return NULL;
+   /* for the ticks and timers */
+   if (!SDL_WasInit( SDL_INIT_TIMER )) {
+      if (SDL_Init( SDL_INIT_TIMER ) < 0)
+	 return NULL;
+      atexit( SDL_Quit );
+   }
+   fflush( outfd );
+   t = tty_open( fileno( outfd ), fileno( infd ) );
+   if (t == NULL)
+      return NULL;
+   sp = new_screen();
+   if (sp == NULL) {
+      tty_close( t );
+      return NULL;
+   }
+   sp->display = FALSE;
+   sp->tty = t;
+   display_char_width = 1;
+   display_char_height = 1;
+   LINES = t->lines;
+   COLS = t->cols;
+   screen_width = COLS;
+   screen_height = LINES;
+
+   stdscr = newwin( LINES, COLS, 0, 0 );
+   if (stdscr == NULL)
+      return newterm_failed( sp, previous );
+   curscr = stdscr;
+   flushinp();
+   globals_changed();
+   return sp;
+#else
+   return NULL;
+#endif
+}
+
+/**
+   newterm makes a new screen and makes it the calling thread's
+   current one, as set_term would.  A screen made while no other has
+   them gets the SDL display and the keyboard.  The others are drawn on offscreen
+   32 bit surfaces, which term_surface returns, and read no input; as
+   long as each is only used by one thread at a time, several of them
+   may be drawn on by different threads at once.  After useterminal,
+   or when SDL has no display to open and outfd is a terminal, the
+   screen is drawn on the terminal outfd instead and reads infd.  type
+   is there for compatibility with curses and is ignored: terminals
+   are taken to understand ANSI sequences and UTF-8.  Returns NULL if
+   the screen could not be set up.
+*/
+SCREEN *newterm(const char *type, FILE *outfd, FILE *infd)
+{
+   SCREEN *previous = SP;
+   SCREEN *sp;
+   bool fallback = FALSE;
+
+#ifdef SDL_CURSES_TTY
+   if (terminal_request)
+      return tty_newterm( outfd, infd );
+   fallback = (display_screen == NULL) && (outfd != NULL) && isatty( fileno( outfd ) );
+#endif
+
+   if (!SDL_WasInit( SDL_INIT_VIDEO )) {
+      if (SDL_Init( SDL_INIT_VIDEO | SDL_INIT_TIMER ) < 0)
+	 return fallback ? tty_newterm( outfd, infd ) : NULL;
+      SDL_EnableUNICODE(1);
+      atexit( SDL_Quit );
+   }
+
+   sp = new_screen();
+   if (sp == NULL)
+      return NULL;
+
+   /* the built-in font unless usefont named another that will open */
+   display_char_width = BUILTIN_FONT_WIDTH;
+   display_char_height = BUILTIN_FONT_HEIGHT;
+   if ((font_file != NULL) && (TTF_Init() == 0)) {
+      SP->ttf_init = TRUE;
+      g_term_font = open_font();
+      /* man is the measure of all things, and this is a monospace
+       * font, so we dimension around '@' */
+      if (g_term_font != NULL)
+	 TTF_SizeText( g_term_font, "@", &display_char_width, &display_char_height);
+   }
+   SP->underline_row = BUILTIN_FONT_HEIGHT - 3;
+   if (g_term_font != NULL)
+      SP->underline_row = TTF_FontAscent( g_term_font ) + 1;
+   if (SP->underline_row >= (int) display_char_height)
+      SP->underline_row = display_char_height - 1;
+
+   /* work out window size needed */
+   screen_width = COLS * display_char_width;
+   screen_height = LINES * display_char_height;
+
+   /* set it up */
+   if (sp->display) {
+      if (!open_display()) {
+	 newterm_failed( sp, previous );
+	 return fallback ? tty_newterm( outfd, infd ) : NULL;
+      }
+      display_screen = sp;
+   } else {
+      screen = SDL_CreateRGBSurface( SDL_SWSURFACE, screen_width, screen_height, 32,
+				     0x00FF0000, 0x0000FF00, 0x000000FF, 0 );
+      if (screen == NULL)
+	 return newterm_failed( sp, previous );
+   }
+
+   stdscr = newwin(LINES, COLS, 0, 0);
+   if (stdscr == NULL)
+      return newterm_failed( sp, previous );
+   curscr = stdscr;
+   flushinp();
+   init_atlas();
+   globals_changed();
+
+   return sp;
+}
+
+/**
+   set_term makes sp the calling thread's current screen, the one the
+   other routines work on, and returns the one that was current.  The
+   globals stdscr, LINES, COLS and the rest change with it.  A NULL sp
+   leaves the thread without a screen.
+*/
+SCREEN *set_term(SCREEN *sp)
+{
+   SCREEN *previous = SP;
+
+   if (previous != NULL)
+      save_globals( previous );
+   SP = sp;
+   if (sp != NULL) {
+      load_globals( sp );
+   } else {
+      screen = NULL;
+      g_term_font = NULL;
+      stdscr = NULL;
+      curscr = NULL;
+   }
+   return previous;
+}
+
+/**
+   delscreen frees a screen and everything that belongs to it: its
+   windows, surfaces, font and glyphs.  If it was the calling thread's
+   current screen the thread is left without one.  endwin should have
+   been called first if the screen is to be used again; it cannot be.
+*/
+void delscreen(SCREEN *sp)
+{
+   SCREEN *previous;
+   DRAW_CMD *cmd;
+   int style, ch;
+   Uint8 *mask;
+
+   if (sp == NULL)
+      return;
+   previous = set_term( sp );
+
+   if (SP->blink_timer != NULL)
+      SDL_RemoveTimer( SP->blink_timer );
+   recordframes( NULL );
+   scr_png( NULL );
+   shmmirror( NULL );
+   streamcells( NULL );
+   while (SP->windows != NULL)
+      delwin( SP->windows );
+   pool_release();
+   /* commands queued after the last window went */
+   hold_queue( NULL );
+   while ((cmd = SP->held) != NULL) {
+      SP->held = cmd->next;
+      free( cmd );
+   }
+
+   while (SP->glyph_count > 0)
+      glyph_evict();
+   for (style = 0; style < GLYPH_STYLES; style++) {
+      for (ch = 0; ch < 128; ch++) {
+	 mask = SP->glyph_ascii[ style ][ ch ];
+	 /* the atlas' glyphs are in the mapped file */
+	 if ((SP->atlas_map != NULL) && (mask >= (Uint8 *) SP->atlas_map) &&
+	     (mask < (Uint8 *) SP->atlas_map + SP->atlas_map_size))
+	    continue;
+	 free( mask );
+      }
+   }
+#ifdef SDL_CURSES_POSIX
+   if (SP->atlas_map != NULL)
+      munmap( SP->atlas_map, SP->atlas_map_size );
+#endif
+
+   if (g_term_font != NULL)
+      TTF_CloseFont( g_term_font );
+   if (SP->ttf_init)
+      TTF_Quit();
+   if ((screen != NULL) && (screen != SP->video))
+      SDL_FreeSurface( screen );
+   free( SP->update_rects );
+   free( SP->cursor_save );
+   free( SP->owners );
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL)
+      tty_close( SP->tty );
+#endif
+   if (sp == display_screen)
+      display_screen = NULL;
+
+   set_term( (previous == sp) ? NULL : previous );
+   free( sp );
+}
+
+/*
+  term_surface returns the surface sp is drawn on: the display's (or
+  the offscreen one it is scaled up from) for the first screen, its
+  own for the others.  It belongs to the screen.
+*/
+SDL_Surface *term_surface(SCREEN *sp)
+{
+   if (sp == NULL)
+      return NULL;
+   return (sp == SP) ? screen : sp->screen;
+}
+
+/**
+   initscr is normally the first curses routine to call when
+   initializing a program.  A few special routines sometimes need
+   to be called before it; these are slk_init, filter, ripoffline,
+   use_env. We do not implement these ;-)
+
+   It is newterm for the display, returning stdscr.
+*/
+WINDOW *initscr(void)
+{
+   if (newterm( NULL, stdout, stdin ) == NULL)
+      return NULL;
+   return stdscr;
+}
+
+/*
+  usefont has initscr draw with the given TrueType or Windows .fon
+  font at ptsize points instead of the built-in 9x16 bitmap font.  A
+  NULL path goes back to the built-in font, as does a font that will
+  not open.  It applies to the screens initscr or newterm make after
+  it is called.
+*/
+int usefont(const char *path, int ptsize)
+{
+   char *copy = NULL;
+
+   if (ptsize <= 0)
+      return ERR;
+   if (path != NULL) {
+      copy = malloc( strlen( path ) + 1 );
+      if (copy == NULL)
+	 return ERR;
+      strcpy( copy, path );
+   }
+   free( font_file );
+   font_file = copy;
+   font_points = ptsize;
+   return OK;
+}
+
+/*
+  usescale makes each pixel of the character grid factor pixels wide
+  and high on the display, from 1 (the default) to 4.  The cells are
+  still drawn at the font's own size and only scaled up on the way to
+  the display.  It applies to the screen that next gets the display.
+*/
+int usescale(int factor)
+{
+   if ((factor < 1) || (factor > 4))
+      return ERR;
+   scale_request = factor;
+   return OK;
+}
+
+/*
+  atlasthreads sets how many threads initscr uses to rasterize the
+  glyphs of a usefont font when they are not cached on disk; 0, the
+  default, is one per processor, and 1 does the work in the calling
+  thread alone.  It applies to the screens made after it is called.
+*/
+int atlasthreads(int n)
+{
+   if (n < 0)
+      return ERR;
+   atlas_threads = n;
+   return OK;
+}
+
+/*
+  useterminal(TRUE) has the screens newterm makes from then on drawn
+  on the terminal it is given, stdout for initscr, rather than with
+  SDL.  Otherwise that happens only when SDL has no display to open.
+  Returns ERR where there is no terminal support.
+*/
+int useterminal(bool bf)
+{
+#ifdef SDL_CURSES_TTY
+   terminal_request = bf;
+   return OK;
+#else
+   return ERR;
+#endif
+}
+
+/*
+  Calling delwin deletes the named window, freeing all memory
+  associated with it (it does not actually erase the window's
+  screen image).  Subwindows must be deleted before the main
+  window can be deleted.
+*/
+
+int delwin(WINDOW *win)
+{
+   WINDOW **link;
+
+   if (win == NULL)
+      return ERR;
+   hold_queue( win );
+   for (link = &SP->windows; *link != NULL; link = &(*link)->next) {
+      if (*link == win) {
+	 *link = win->next;
+	 break;
+      }
+   }
+   clear_blink_rows( win );
+   disown_cells( win );
+   backingstore( win, FALSE );
+   free_rows( win );
+   pool_free( win->cells );
+   pool_free( win );
+   SP->live_windows--;
+   return OK;
+}
+
+/*
+  A program should always call endwin before exiting or escaping
+  from curses mode temporarily.  This routine restores tty modes,
+  moves the cursor to the lower left-hand corner of the screen
+  and resets the terminal into the proper non-visual mode.
+  Calling refresh or doupdate after a temporary escape causes the
+  program to resume visual mode.
+*/
+
+int endwin(void)
+{
+#ifdef SDL_CURSES_TTY
+   /* the next refresh puts the terminal back in the mode it is drawn in */
+   if ((SP != NULL) && (SP->tty != NULL)) {
+      tty_leave( SP->tty );
+      return OK;
+   }
+#endif
+   /* we don't have any sensible way of doing this with SDL, so it fails */
+   return ERR;
+}
+
+/*
+  Calling mvwin moves the window so that the upper left-hand
+  corner is at position (x, y).  If the move would cause the
+  window to be off the screen, it is an error and the window is
+  not moved.  Moving subwindows is allowed, but should be
+  avoided.
+*/
+int mvwin(WINDOW *win, int y, int x)
+{
+   win->x = x;
+   win->y = y;
+   touchwin(win);
+   return OK;
+}
+
+/* move win's cells into new arrays for a lines by columns window,
+ * compressed or not, keeping the part that is in both sizes */
+static int remake_cells(WINDOW *win, int lines, int columns, bool packed)
+{
+   WINDOW fresh;
+   void *cells;
+   int y, x;
+   int keep_h = (lines < win->height) ? lines : win->height;
+   int keep_w = (columns < win->width) ? columns : win->width;
+   bool cut = (columns < win->width);
+
+   cells = pool_alloc( cells_size( lines, columns, packed ) );
+   if (cells == NULL)
+      return ERR;
+   lay_out_cells( &fresh, cells, lines, columns, packed );
+   fresh.height = lines;
+   fresh.width = columns;
+   for (y = 0; y < keep_h; y++) {
+      if (!row_expand( win, y ) || !row_expand( &fresh, y )) {
+	 free_rows( &fresh );
+	 pool_free( cells );
+	 return ERR;
+      }
+      memcpy( fresh.lines[y], win->lines[y], keep_w * sizeof(wchar_t) );
+      memcpy( fresh.alines[y], win->alines[y], keep_w * sizeof(attr_t) );
+      if (win->firstch[y] != _NOCHANGE) {
+	 fresh.firstch[y] = (win->firstch[y] < keep_w) ? win->firstch[y] : keep_w - 1;
+	 fresh.lastch[y] = (win->lastch[y] < keep_w) ? win->lastch[y] : keep_w - 1;
+      }
+   }
+
+   /* arrays in the window's own block are left there unused */
+   clear_blink_rows( win );
+   free_rows( win );
+   pool_free( win->cells );
+
+   win->cells = cells;
+   win->text = fresh.text;
+   win->attrib = fresh.attrib;
+   win->lines = fresh.lines;
+   win->alines = fresh.alines;
+   win->runs = fresh.runs;
+   win->firstch = fresh.firstch;
+   win->lastch = fresh.lastch;
+   win->blinkrows = fresh.blinkrows;
+   win->height = lines;
+   win->width = columns;
+
+   for (y = 0; y < keep_h; y++) {
+      /* a double-width character cut in half by the new edge goes */
+      if (cut && (char_cells( win->lines[y][keep_w - 1] ) == 2)) {
+	 win->lines[y][keep_w - 1] = ' ';
+	 touch_span( win, y, keep_w - 1, keep_w - 1 );
+      }
+      for (x = 0; x < keep_w; x++)
+	 mark_blink( win, y, win->alines[y][x] );
+      if (packed)
+	 row_pack( win, y );
+   }
+   return OK;
+}
+
+/*
+  wresize makes the window lines rows by columns columns, keeping the
+  contents of the part that is in both the old and the new size.
+  Cells that are new are blank and are the only ones marked to be
+  drawn; changes still pending in the kept part stay pending.  The
+  cursor is moved inside the window if it is now outside.
+*/
+int wresize(WINDOW *win, int lines, int columns)
+{
+   int y;
+   int keep_h = (lines < win->height) ? lines : win->height;
+   int keep_w = (columns < win->width) ? columns : win->width;
+
+   if ((lines <= 0) || (columns <= 0))
+      return ERR;
+   if ((lines == win->height) && (columns == win->width))
+      return OK;
+   if (remake_cells( win, lines, columns, win->runs != NULL ) != OK)
+      return ERR;
+
+   /* only what was not there before needs drawing */
+   if (keep_w < columns)
+      for (y = 0; y < keep_h; y++)
+	 touch_span( win, y, keep_w, columns - 1 );
+   touchline( win, keep_h, lines - keep_h );
+
+   /* the backing store is redrawn whole at the new size */
+   if (win->backing != NULL) {
+      backingstore( win, FALSE );
+      backingstore( win, TRUE );
+   }
+
+   if (win->cy >= lines)
+      win->cy = lines - 1;
+   if (win->cx >= columns)
+      win->cx = columns - 1;
+   return OK;
+}
+
+/*
+  compressrows(win, TRUE) keeps win's rows as runs of cells that are
+  alike, for large windows that are mostly blank: a blank row takes
+  no room at all.  A row is expanded while it is written and packed
+  again while the program waits for a key; calling compressrows on a
+  window that is already compressed packs its rows at once.
+  compressrows(win, FALSE) gives it ordinary rows again.  With win
+  NULL, it sets whether the windows newwin makes on the current
+  screen from then on are compressed; such windows never have cell
+  arrays at all, where one compressed later keeps the arrays in its
+  own block unused until it is deleted.
+*/
+int compressrows(WINDOW *win, bool bf)
+{
+   if (SP == NULL)
+      return ERR;
+   if (win == NULL) {
+      SP->pack_new = bf;
+      return OK;
+   }
+   if (bf && (win->runs != NULL)) {
+      pack_rows( win );
+      return OK;
+   }
+   if (!bf && (win->runs == NULL))
+      return OK;
+   return remake_cells( win, win->height, win->width, bf );
+}
+
+/*
+ * cursor
+ */
+
+/* The cursor is an overlay: the pixels under it are saved when it is
+ * drawn and put back when it moves, so showing, hiding or moving it
+ * never touches a window's cells or change tracking. */
+
+static bool cursor_rect(SDL_Rect *rect)
+{
+   int px = SP->cursor_col * display_char_width;
+   int py = SP->cursor_row * display_char_height;
+
+   if ((px < 0) || (py < 0) ||
+       (px + display_char_width > screen_width) ||
+       (py + display_char_height > screen_height))
+      return FALSE;
+   rect->x = px;
+   rect->y = py;
+   rect->w = display_char_width;
+   rect->h = display_char_height;
+   return TRUE;
+}
+
+static Uint32 get_pixel(const Uint8 *p, int bpp)
+{
+   switch (bpp) {
+      case 1:
+	 return *p;
+      case 2:
+	 return *(const Uint16 *) p;
+      case 3:
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	 return (p[0] << 16) | (p[1] << 8) | p[2];
+#else
+	 return p[0] | (p[1] << 8) | (p[2] << 16);
+#endif
+      case 4:
+	 return *(const Uint32 *) p;
+   }
+   return 0;
+}
+
+/* take the cursor off the locked screen, adding the rectangle it
+ * uncovered to rects; returns the number of rectangles added */
+static int erase_cursor(SDL_Rect *rects)
+{
+   int bpp = screen->format->BytesPerPixel;
+   int row;
+
+   if (!SP->cursor_drawn)
+      return 0;
+   SP->cursor_drawn = FALSE;
+   if (!cursor_rect( rects ))
+      return 0;
+   for (row = 0; row < rects->h; row++)
+      memcpy( (Uint8 *) screen->pixels + (rects->y + row) * screen->pitch + rects->x * bpp,
+	      SP->cursor_save + row * rects->w * bpp, rects->w * bpp );
+   return 1;
+}
+
+/* draw the cursor on the locked screen at cursor_col, cursor_row */
+static int draw_cursor(SDL_Rect *rects)
+{
+   int bpp = screen->format->BytesPerPixel;
+   Uint32 invert = (bpp == 1) ? 0xFF :
+      (screen->format->Rmask | screen->format->Gmask | screen->format->Bmask);
+   int row, x, first;
+   Uint8 *p;
+
+   if ((SP->cursor_visibility == 0) || !cursor_rect( rects ))
+      return 0;
+   if (SP->cursor_save == NULL) {
+      SP->cursor_save = malloc( display_char_width * display_char_height * 4 );
+      if (SP->cursor_save == NULL)
+	 return 0;
+   }
+
+   /* a normal cursor is an underline, a very visible one the block */
+   first = (SP->cursor_visibility == 2) ? 0 :
+      rects->h - ((rects->h >= 8) ? rects->h / 8 : 1);
+   for (row = 0; row < rects->h; row++) {
+      p = (Uint8 *) screen->pixels + (rects->y + row) * screen->pitch + rects->x * bpp;
+      memcpy( SP->cursor_save + row * rects->w * bpp, p, rects->w * bpp );
+      if (row >= first)
+	 for (x = 0; x < rects->w; x++, p += bpp)
+	    put_pixel( p, bpp, get_pixel( p, bpp ) ^ invert );
+   }
+   SP->cursor_drawn = TRUE;
+   return 1;
+}
+
+/* move the cursor to where win has left it, unless win is leaveok */
+static void place_cursor(WINDOW *win)
+{
+   int x = (win->cx < win->width) ? win->cx : win->width - 1;
+
+   if (win->leaveok)
+      return;
+   SP->cursor_col = win->x + x;
+   SP->cursor_row = win->y + win->cy;
+}
+
+/* the columns the character at row y, column x of win is drawn
+ * across: 2 for a double-width character that is whole and all on
+ * the screen, otherwise 1 */
+static int cell_span(WINDOW *win, int y, int x)
+{
+   if ((char_cells( cell_char( win, y, x ) ) == 2) && (x + 1 < win->width) &&
+       (cell_char( win, y, x + 1 ) == WIDE_FILLER) &&
+       ((win->x + x + 2) * (int) display_char_width <= (int) screen_width))
+      return 2;
+   return 1;
+}
+
+/* draw wc with attributes attrib across span columns with its top
+ * left corner at pixel px, py of the locked surface, returning span.
+ * A stray second half of a double-width character is drawn as a
+ * blank. */
+static int render_char(wchar_t wc, attr_t attrib, int span, SDL_Surface *surface,
+		       int px, int py)
+{
+   SDL_Color fg;
+   SDL_Color bg;
+   int style;
+   int builtin;
+
+   if (wc == WIDE_FILLER)
+      wc = ' ';
+   cell_colors( attrib, &fg, &bg );
+   if (BLINK( attrib ) && !SP->blink_visible)
+      fg = bg;
+
+   /* the built-in font needs no cache: its rows are drawn as they are */
+   style = glyph_style( wc, attrib );
+   if ((g_term_font == NULL) && !(style & GLYPH_ACS) &&
+       ((builtin = builtin_glyph( wc )) >= 0)) {
+      draw_bitmap_glyph( surface, px, py, builtin_font[ builtin ],
+			 (style & GLYPH_BOLD) != 0, UNDERLINE( attrib ) != 0, fg, bg );
+      return span;
+   }
+
+   draw_glyph( surface, px, py, get_glyph( wc, attrib ), char_cells( wc ) * display_char_width,
+	       span * display_char_width, UNDERLINE( attrib ) != 0, fg, bg );
+   return span;
+}
+
+/* draw the cell at row y, column x of win with its top left corner at
+ * pixel px, py of the locked surface, returning the number of columns
+ * drawn.  A double-width character is drawn whole from its first
+ * column. */
+static int render_cell(WINDOW *win, int y, int x, SDL_Surface *surface, int px, int py)
+{
+   return render_char( cell_char( win, y, x ), cell_attrib( win, y, x ),
+		       cell_span( win, y, x ), surface, px, py );
+}
+
+/* draw columns x..xend - 1 of row y of win on the locked surface,
+ * where column 0 is at pixel px, py.  The runs of a packed row are
+ * walked as they are, a run of blanks being drawn as one rectangle
+ * of its background. */
+static void render_row(WINDOW *win, int y, int x, int xend, SDL_Surface *surface,
+		       int px, int py)
+{
+   const RUN *run = &blank_run;
+   SDL_Color fg;
+   SDL_Color bg;
+   int count = 1;
+   int start, end, stop, span, i;
+
+   if (win->lines[y] != NULL) {
+      while (x < xend)
+	 x += render_cell( win, y, x, surface, px + x * display_char_width, py );
+      return;
+   }
+
+   if (win->runs[y] != NULL) {
+      run = win->runs[y]->run;
+      count = win->runs[y]->count;
+   }
+   for (i = 0, start = 0; (i < count) && (x < xend); start = end, i++) {
+      end = (run == &blank_run) ? win->width : start + run[i].len;
+      if (end <= x)
+	 continue;
+      stop = (end < xend) ? end : xend;
+      if ((run[i].wc == ' ') && !UNDERLINE( run[i].attr )) {
+	 cell_colors( run[i].attr, &fg, &bg );
+	 draw_glyph( surface, px + x * display_char_width, py, NULL, 0,
+		     (stop - x) * display_char_width, FALSE, fg, bg );
+	 x = stop;
+	 continue;
+      }
+      for (; x < stop; x += span) {
+	 /* the second half of a double-width character is the run
+	    after the one its first half ends */
+	 span = 1;
+	 if ((char_cells( run[i].wc ) == 2) && (x + 1 == end) && (i + 1 < count) &&
+	     (run[i + 1].wc == WIDE_FILLER) &&
+	     ((win->x + x + 2) * (int) display_char_width <= (int) screen_width))
+	    span = 2;
+	 render_char( run[i].wc, run[i].attr, span, surface, px + x * display_char_width, py );
+      }
+   }
+}
+
+/* draw a cell in its place on the screen */
+static int draw_cell(WINDOW *win, int y, int x)
+{
+   return render_cell( win, y, x, screen, ( win->x + x ) * display_char_width,
+		       ( win->y + y ) * display_char_height );
+}
+
+/* the screen rectangle of a cell, FALSE if it is not all on screen */
+static bool cell_rect(WINDOW *win, int y, int x, SDL_Rect *rect)
+{
+   int px = ( win->x + x ) * display_char_width;
+   int py = ( win->y + y ) * display_char_height;
+
+   if ((y < 0) || (x < 0) || (y >= win->height) || (x >= win->width) ||
+       (px < 0) || (py < 0) ||
+       (px + display_char_width > screen_width) ||
+       (py + display_char_height > screen_height))
+      return FALSE;
+   rect->x = px;
+   rect->y = py;
+   rect->w = cell_span( win, y, x ) * display_char_width;
+   rect->h = display_char_height;
+   return TRUE;
+}
+
+
+/* bring win's backing store up to date, drawing the cells changed
+ * since it was last, or all of them if its pixels were dropped;
+ * NULL if the window is to be drawn on the screen directly */
+static SDL_Surface *backing_sync(WINDOW *win)
+{
+   BACKING *store = win->backing;
+   unsigned long bytes;
+   int y, x, xend;
+
+   if ((store->surface != NULL) &&
+       (store->surface->format->BitsPerPixel != screen->format->BitsPerPixel))
+      backing_drop( store );
+
+   if (store->surface == NULL) {
+      bytes = (unsigned long) win->width * display_char_width *
+	 win->height * display_char_height * screen->format->BytesPerPixel;
+      if (bytes > SP->backing_limit)
+	 return NULL;
+      while ((SP->backing_bytes + bytes > SP->backing_limit) && backing_evict( win ))
+	 ;
+      store->surface = like_surface( screen, win->width * display_char_width,
+				     win->height * display_char_height );
+      if (store->surface == NULL)
+	 return NULL;
+      SP->backing_bytes += store->surface->pitch * store->surface->h;
+      for (y = 0; y < win->height; y++)
+	 backing_touch( store, y, 0, win->width - 1 );
+   }
+
+   /* a software surface, which needs no locking */
+   for (y = 0; y < win->height; y++) {
+      if (store->first[y] == _NOCHANGE)
+	 continue;
+      x = store->first[y];
+      xend = store->last[y] + 1;
+      if (is_covered( win, y, x ))
+	 x--;
+      if ((xend < win->width) && is_covered( win, y, xend ))
+	 xend++;
+      render_row( win, y, x, xend, store->surface, 0, y * display_char_height );
+      store->first[y] = _NOCHANGE;
+      store->last[y] = _NOCHANGE;
+   }
+   store->shown = ++SP->backing_clock;
+   return store->surface;
+}
+
+/* copy a w by h pixel rectangle between locked surfaces of one format */
+static void copy_rect(SDL_Surface *dst, int dx, int dy, SDL_Surface *src, int sx, int sy,
+		      int w, int h)
+{
+   int bpp = src->format->BytesPerPixel;
+   const Uint8 *from = (const Uint8 *) src->pixels + sy * src->pitch + sx * bpp;
+   Uint8 *to = (Uint8 *) dst->pixels + dy * dst->pitch + dx * bpp;
+
+   for (; h > 0; h--, from += src->pitch, to += dst->pitch)
+      memcpy( to, from, w * bpp );
+}
+
+
+/*
+ * scaling
+ */
+
+/* With a scale factor above 1, cells are drawn at the font's own size
+ * on screen, an offscreen surface, and the rectangles presented are
+ * blown up scale_factor times into the video surface by repeating
+ * pixels.  Only what changed is scaled, so the cost follows the
+ * native renderer's. */
+
+/* repeat each of n pixels of src scale_factor times into dst */
+static void scale_row(Uint8 *dst, const Uint8 *src, int n, int bpp)
+{
+   int x, k;
+
+   if (bpp == 4) {
+      const Uint32 *s = (const Uint32 *) src;
+      Uint32 *d = (Uint32 *) dst;
+
+      x = 0;
+#ifdef __SSE2__
+      if (SP->scale_factor == 2) {
+	 for (; x + 4 <= n; x += 4, d += 8) {
+	    __m128i v = _mm_loadu_si128( (const __m128i *) (s + x) );
+	    _mm_storeu_si128( (__m128i *) d, _mm_unpacklo_epi32( v, v ) );
+	    _mm_storeu_si128( (__m128i *) (d + 4), _mm_unpackhi_epi32( v, v ) );
+	 }
+      } else if (SP->scale_factor == 4) {
+	 for (; x + 4 <= n; x += 4, d += 16) {
+	    __m128i v = _mm_loadu_si128( (const __m128i *) (s + x) );
+	    _mm_storeu_si128( (__m128i *) d, _mm_shuffle_epi32( v, 0x00 ) );
+	    _mm_storeu_si128( (__m128i *) (d + 4), _mm_shuffle_epi32( v, 0x55 ) );
+	    _mm_storeu_si128( (__m128i *) (d + 8), _mm_shuffle_epi32( v, 0xaa ) );
+	    _mm_storeu_si128( (__m128i *) (d + 12), _mm_shuffle_epi32( v, 0xff ) );
+	 }
+      }
+#endif
+      for (; x < n; x++)
+	 for (k = 0; k < SP->scale_factor; k++)
+	    *d++ = s[x];
+      return;
+   }
+
+   for (x = 0; x < n; x++, src += bpp)
+      for (k = 0; k < SP->scale_factor; k++, dst += bpp)
+	 memcpy( dst, src, bpp );
+}
+
+/* scale rect of screen into video, and make rect the area it covers
+ * there */
+static void scale_rect(SDL_Rect *rect)
+{
+   int bpp = screen->format->BytesPerPixel;
+   int w = rect->w;
+   int y, k;
+   const Uint8 *src;
+   Uint8 *dst;
+
+   if (rect->x + w > screen->w)
+      w = screen->w - rect->x;
+   src = (const Uint8 *) screen->pixels + rect->y * screen->pitch + rect->x * bpp;
+   dst = (Uint8 *) SP->video->pixels + rect->y * SP->scale_factor * SP->video->pitch +
+      rect->x * SP->scale_factor * bpp;
+   for (y = 0; (y < rect->h) && (rect->y + y < screen->h); y++) {
+      scale_row( dst, src, w, bpp );
+      for (k = 1; k < SP->scale_factor; k++)
+	 memcpy( dst + k * SP->video->pitch, dst, w * SP->scale_factor * bpp );
+      src += screen->pitch;
+      dst += SP->scale_factor * SP->video->pitch;
+   }
+
+   rect->x *= SP->scale_factor;
+   rect->y *= SP->scale_factor;
+   rect->w *= SP->scale_factor;
+   rect->h *= SP->scale_factor;
+}
+
+/* put the rectangles of screen that changed on the display; rects
+ * are left in video coordinates */
+static void present_rects(int nrects, SDL_Rect *rects)
+{
+   int i;
+
+   if ((nrects <= 0) || (SP->video == NULL))
+      return;
+   if (SP->video != screen) {
+      if (SDL_MUSTLOCK( SP->video ))
+	 if (SDL_LockSurface( SP->video ) < 0)
+	    return;
+      for (i = 0; i < nrects; i++)
+	 scale_rect( &rects[ i ] );
+      if (SDL_MUSTLOCK( SP->video ))
+	 SDL_UnlockSurface( SP->video );
+   }
+   SDL_UpdateRects( SP->video, nrects, rects );
+}
+
+/* draw and present just one cell, without looking at the rest of
+ * the window; the cost is the same whatever the window's size */
+static void refresh_cell(WINDOW *win, int y, int x)
+{
+   SDL_Rect rects[ 3 ];
+   int nrects = 1;
+   int x0 = x;
+
+   /* the second half of a double-width character is drawn with it */
+   if ((x < win->width) && is_covered( win, y, x ))
+      x0 = x - 1;
+   if (!cell_rect( win, y, x0, rects ))
+      return;
+
+   if (SP->tty != NULL) {
+      place_cursor( win );
+   } else {
+      if (SDL_MUSTLOCK( screen ))
+	 if (SDL_LockSurface( screen ) < 0)
+	    return;
+      nrects += erase_cursor( rects + nrects );
+      draw_cell( win, y, x0 );
+      place_cursor( win );
+      nrects += draw_cursor( rects + nrects );
+      if (SDL_MUSTLOCK( screen ))
+	 SDL_UnlockSurface( screen );
+      present_rects( nrects, rects );
+   }
+   claim_cells( win, y, x0, x0 + cell_span( win, y, x0 ) );
+   sink_span( win, y, x0, x0 + cell_span( win, y, x0 ) );
+   sink_frame_end();
+
+   /* if that was the only change in the row, the row is clean again */
+   if ((win->firstch[ y ] >= x0) && (win->lastch[ y ] < x0 + cell_span( win, y, x0 ))) {
+      win->firstch[ y ] = _NOCHANGE;
+      win->lastch[ y ] = _NOCHANGE;
+   }
+}
+
+/* if the blink timer has fired, flip the phase and redraw the
+ * blinking cells of the flagged rows, presenting them in one call;
+ * cells another window was drawn over since are left to it */
+static void blink_update(void)
+{
+   WINDOW *win;
+   SDL_Rect rect;
+   int nrects, y, x;
+   bool found;
+
+   /* room for the cursor's old and new places at least */
+   if (!SP->blink_due || !grow_update_rects( 2 ))
+      return;
+   if (SDL_MUSTLOCK( screen ))
+      if (SDL_LockSurface( screen ) < 0)
+	 return;
+   SP->blink_due = FALSE;
+   SP->blink_visible = !SP->blink_visible;
+
+   nrects = erase_cursor( SP->update_rects );
+
+   for (win = SP->windows; win != NULL; win = win->next) {
+      for (y = 0; y < win->height; y++) {
+	 if (!win->blinkrows[ y ])
+	    continue;
+	 found = FALSE;
+	 for (x = 0; x < win->width; x++) {
+	    if (!BLINK( cell_attrib( win, y, x ) ) || is_covered( win, y, x ))
+	       continue;
+	    found = TRUE;
+	    if (!owns_cell( win, y, x ) || !cell_rect( win, y, x, &rect ) ||
+		!grow_update_rects( nrects + 2 ))
+	       continue;
+	    draw_cell( win, y, x );
+	    SP->update_rects[ nrects++ ] = rect;
+	    if (win->backing != NULL)
+	       backing_touch( win->backing, y, x, x + cell_span( win, y, x ) - 1 );
+	 }
+	 if (!found)
+	    set_blink_row( win, y, FALSE );
+      }
+   }
+
+   nrects += draw_cursor( SP->update_rects + nrects );
+   if (SDL_MUSTLOCK( screen ))
+      SDL_UnlockSurface( screen );
+   present_rects( nrects, SP->update_rects );
+
+   /* nothing left to blink: stop the timer, leaving the text shown */
+   if ((SP->blink_rows == 0) && (SP->blink_timer != NULL)) {
+      SDL_RemoveTimer( SP->blink_timer );
+      SP->blink_timer = NULL;
+      SP->blink_visible = TRUE;
+   }
+}
+
+#ifdef SDL_CURSES_TTY
+
+/* wrefresh for a screen on a terminal: the changed cells only go to
+ * the sinks, the terminal's among them */
+static int tty_refresh(WINDOW *win)
+{
+   int y, x0, xend;
+
+   if (!SP->tty->raw)
+      tty_enter( SP->tty );
+   for (y = 0; y < win->height; y++) {
+      if (win->firstch[y] == _NOCHANGE)
+	 continue;
+      x0 = win->firstch[y];
+      xend = win->lastch[y] + 1;
+      if (is_covered( win, y, x0 ))
+	 x0--;
+      if ((xend < win->width) && is_covered( win, y, xend ))
+	 xend++;
+      if ((win->y + y < 0) || (win->y + y >= LINES))
+	 xend = x0;
+      if (win->x + xend > COLS)
+	 xend = COLS - win->x;
+      win->firstch[y] = _NOCHANGE;
+      win->lastch[y] = _NOCHANGE;
+      if (x0 < xend)
+	 sink_span( win, y, x0, xend );
+   }
+   place_cursor( win );
+   sink_frame_end();
+   return OK;
+}
+
+#endif /* SDL_CURSES_TTY */
+
+/*
+  The refresh and wrefresh routines (or wnoutrefresh and
+  doupdate) must be called to get actual output to the terminal,
+  as other routines merely manipulate data structures.  The
+  routine wrefresh copies the named window to the physical
+  terminal screen, taking into account what is already there to
+  do optimizations.  The refresh routine is the same, using
+  stdscr as the default window.  Unless leaveok has been enabled,
+  the physical cursor of the terminal is left at the location of
+  the cursor for that window.
+*/
+int wrefresh( WINDOW *win )
+{
+   // actually draw
+   int xat, yat, xend;
+   int yscreen;
+   int nrects;
+   SDL_Surface *store;
+
+   run_queue();
+
+   /* the caller is behind the keyboard: keep the changes for later */
+   if ((SP->typeahead_fd >= 0) && input_pending())
+      return OK;
+
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL)
+      return tty_refresh( win );
+#endif
+   blink_update();
+
+   /* a rectangle per row, plus where the cursor was and where it goes */
+   if (!grow_update_rects( win->height + 2 ))
+      return ERR;
+
+   /* rows are copied from the backing store, if there is one */
+   store = (win->backing != NULL) ? backing_sync( win ) : NULL;
+
+   if (SDL_MUSTLOCK( screen ))
+      if (SDL_LockSurface( screen ) < 0)
+	 return ERR;
+
+   nrects = erase_cursor( SP->update_rects );
+
+   for ( yat = 0; yat < win->height; yat++ ) {
+
+      if (win->firstch[yat] == _NOCHANGE)
+	 continue;
+
+      yscreen = ( yat + win->y ) * display_char_height;
+      xat = win->firstch[yat];
+      xend = win->lastch[yat] + 1;
+
+      /* double-width characters are redrawn whole */
+      if (is_covered( win, yat, xat ))
+	 xat--;
+      if ((xend < win->width) && is_covered( win, yat, xend ))
+	 xend++;
+
+      /* only the part of the window that is on the screen is drawn */
+      if ((yscreen >= (int) screen_height) || (yscreen < 0))
+	 xend = xat;
+      if (( win->x + xend ) * display_char_width > screen_width)
+	 xend = screen_width / display_char_width - win->x;
+
+      win->firstch[yat] = _NOCHANGE;
+      win->lastch[yat] = _NOCHANGE;
+      if (xat >= xend)
+	 continue;
+      claim_cells( win, yat, xat, xend );
+      sink_span( win, yat, xat, xend );
+
+      SP->update_rects[ nrects ].x = ( win->x + xat ) * display_char_width;
+      SP->update_rects[ nrects ].y = yscreen;
+      SP->update_rects[ nrects ].w = ( xend - xat ) * display_char_width;
+      SP->update_rects[ nrects ].h = display_char_height;
+      nrects++;
+
+      if (store != NULL)
+	 copy_rect( screen, ( win->x + xat ) * display_char_width, yscreen, store,
+		    xat * display_char_width, yat * display_char_height,
+		    ( xend - xat ) * display_char_width, display_char_height );
+      else
+	 render_row( win, yat, xat, xend, screen, win->x * display_char_width, yscreen );
+   }
+
+   place_cursor( win );
+   nrects += draw_cursor( SP->update_rects + nrects );
+
+   if (SDL_MUSTLOCK( screen ))
+      SDL_UnlockSurface( screen );
+
+   present_rects( nrects, SP->update_rects );
+   sink_frame_end();
+   return OK;
+}
+
+/* copy the top left w by h pixels of src to dst, of the same format */
+static void copy_pixels(SDL_Surface *dst, SDL_Surface *src, int w, int h)
+{
+   int bpp = src->format->BytesPerPixel;
+   int y;
+
+   if (SDL_MUSTLOCK( src ))
+      if (SDL_LockSurface( src ) < 0)
+	 return;
+   if (SDL_MUSTLOCK( dst ))
+      if (SDL_LockSurface( dst ) < 0) {
+	 if (SDL_MUSTLOCK( src ))
+	    SDL_UnlockSurface( src );
+	 return;
+      }
+   for (y = 0; y < h; y++)
+      memcpy( (Uint8 *) dst->pixels + y * dst->pitch,
+	      (Uint8 *) src->pixels + y * src->pitch, w * bpp );
+   if (SDL_MUSTLOCK( dst ))
+      SDL_UnlockSurface( dst );
+   if (SDL_MUSTLOCK( src ))
+      SDL_UnlockSurface( src );
+}
+
+/*
+  resizeterm changes the size of the screen to lines by columns
+  cells, setting the video mode to match, and resizes stdscr with
+  wresize.  What was already drawn is carried over pixel for pixel,
+  so only the cells that are new get drawn at the next refresh.  It
+  is called by wgetch when the user resizes the window, which then
+  returns KEY_RESIZE.  It returns ERR, with the screen left as it
+  was, for more than RESIZE_MAX lines or columns or when the surfaces
+  or the video mode cannot be had.
+*/
+#define RESIZE_MAX (0x7fff)
+
+int resizeterm(int lines, int columns)
+{
+   unsigned int width = columns * display_char_width;
+   unsigned int height = lines * display_char_height;
+   int keep_w = (width < screen_width) ? width : screen_width;
+   int keep_h = (height < screen_height) ? height : screen_height;
+   SDL_Surface *kept;
+   SDL_Surface *fresh = NULL;
+   SDL_Surface *video;
+   SDL_Rect rects[ 2 ];
+   bool direct;
+
+   if ((SP == NULL) || (lines <= 0) || (columns <= 0) ||
+       (lines > RESIZE_MAX) || (columns > RESIZE_MAX))
+      return ERR;
+   if ((lines == LINES) && (columns == COLS))
+      return OK;
+
+   /* a terminal has no pixels to keep */
+   if (SP->tty != NULL) {
+      screen_width = width;
+      screen_height = height;
+      LINES = lines;
+      COLS = columns;
+      wresize( stdscr, lines, columns );
+      sink_resize( lines, columns );
+      globals_changed();
+      return OK;
+   }
+
+   /* the cursor is not part of what is kept */
+   if (SDL_MUSTLOCK( screen ))
+      if (SDL_LockSurface( screen ) < 0)
+	 return ERR;
+   erase_cursor( rects );
+   if (SDL_MUSTLOCK( screen ))
+      SDL_UnlockSurface( screen );
+
+   /* setting the mode replaces the video surface, so when cells are
+      drawn straight onto it the whole old picture is set aside first,
+      to go back to if the new mode cannot be had; otherwise the old
+      offscreen surface is what is kept, and the new one is made
+      before anything changes.  A screen without the display only has
+      the offscreen surface. */
+   direct = (screen == SP->video);
+   kept = screen;
+   if (direct) {
+      kept = like_surface( screen, screen_width, screen_height );
+      if (kept == NULL)
+	 return ERR;
+      copy_pixels( kept, screen, screen_width, screen_height );
+   } else {
+      fresh = like_surface( kept, width, height );
+      if (fresh == NULL)
+	 return ERR;
+   }
+
+   if (SP->display) {
+      video = SDL_SetVideoMode( width * SP->scale_factor, height * SP->scale_factor,
+				0, SDL_RESIZABLE );
+      if (video == NULL) {
+	 /* back to the old mode, which worked before, redrawn in full;
+	    without even that the screen is drawn offscreen only, until
+	    a later resize gets a mode */
+	 SP->video = SDL_SetVideoMode( screen_width * SP->scale_factor,
+				       screen_height * SP->scale_factor, 0, SDL_RESIZABLE );
+	 if (direct && (SP->video != NULL)) {
+	    screen = SP->video;
+	    SDL_FreeSurface( kept );
+	    globals_changed();
+	 } else if (direct) {
+	    screen = kept;
+	    globals_changed();
+	 } else {
+	    SDL_FreeSurface( fresh );
+	 }
+	 touchwin( stdscr );
+	 return ERR;
+      }
+      SP->video = video;
+   }
+
+   if (direct)
+      fresh = SP->video;
+   copy_pixels( fresh, kept, keep_w, keep_h );
+   SDL_FreeSurface( kept );
+   screen = fresh;
+
+   screen_width = width;
+   screen_height = height;
+   LINES = lines;
+   COLS = columns;
+   wresize( stdscr, lines, columns );
+   sink_resize( lines, columns );
+   globals_changed();
+
+   /* the display was replaced: put back what was kept */
+   rects[0].x = 0;
+   rects[0].y = 0;
+   rects[0].w = keep_w;
+   rects[0].h = keep_h;
+   present_rects( 1, rects );
+   return OK;
+}
+
+/* resize the screen to fit a window the user made w by h pixels */
+static void resize_to_fit(int w, int h)
+{
+   int columns = w / (int) (display_char_width * SP->scale_factor);
+   int lines = h / (int) (display_char_height * SP->scale_factor);
+
+   resizeterm( (lines > 0) ? lines : 1, (columns > 0) ? columns : 1 );
+}
+
+int wmove( WINDOW *win, int y, int x )
+{
+   if ((x < 0) || (y < 0) || (y >= win->height) || (x >= win->width))
+      return ERR;
+   win->cx = x;
+   win->cy = y;
+   return OK;
+}
+
+/*
+  The addch, waddch, mvaddch and mvwaddch routines put the
+  character ch into the given window at its current window
+  position, which is then advanced.  They are analogous to
+  putchar in stdio(3).  If the advance is at the right margin,
+  the cursor automatically wraps to the beginning of the next
+  line.  At the bottom of the current scrolling region, if
+  scrollok is enabled, the scrolling region is scrolled up one
+  line.
+
+  If ch is a tab, newline, or backspace, the cursor is moved
+  appropriately within the window.  Backspace moves the cursor
+  one character left; at the left edge of a window it does
+  nothing.  Newline does a clrtoeol, then moves the cursor to the
+  window left margin on the next line, scrolling the window if on
+  the last line.  Tabs are considered to be at every eighth
+  column.  The tab interval may be altered by setting the TABSIZE
+  variable.
+
+*/
+
+/* put wc with attributes attrs at the cursor and advance it; the
+ * guts of waddch and wadd_wch */
+static int add_wchar( WINDOW *win, wchar_t wc, attr_t attrs )
+{
+   int cells;
+
+   if ( wc == '\t' ) {
+      win->cx += 4 - ( win->cx % 4 );
+   }
+
+   else {
+      if ( wc == '\r' ) {
+	 win->cx = 0;
+      }
+
+      else {
+	 if ( wc == '\n' ) {
+	    win->cx = 0;
+	    win->cy++;
+	 }
+
+	 else {
+	    /* combining marks are not drawn */
+	    cells = char_cells( wc );
+	    if ( cells == 0 )
+	       return OK;
+
+	    if ( ( win->cx < win->width ) && ( win->cy < win->height ) ) {
+	       put_wcell( win, win->cy, win->cx, wc, attrs );
+	       touch_span( win, win->cy, win->cx,
+			   ( win->cx + cells <= win->width ) ? win->cx + cells - 1 : win->cx );
+	    }
+
+	    win->cx += cells;
+
+	 }
+      }
+   }
+   return OK;
+}
+
+int waddch( WINDOW *win, chtype c )
+{
+   return add_wchar( win, (wchar_t) ( c & A_CHARTEXT ), cell_attr( win, c ) );
+}
+
+/*
+  The echochar and wechochar routines are equivalent to a call to
+  addch followed by a call to refresh, or a call to waddch followed by
+  a call to wrefresh, except that only the cell written is drawn and
+  presented.  Other changes pending in the window wait for the next
+  refresh.
+*/
+int wechochar( WINDOW *win, const chtype ch )
+{
+   int y = win->cy;
+   int x = win->cx;
+
+   if (waddch( win, ch ) != OK)
+      return ERR;
+   refresh_cell( win, y, x );
+   return OK;
+}
+
+int mvwaddch(WINDOW *win, int y, int x, const chtype ch)
+{
+   if (wmove(win,y,x) != OK)
+      return ERR;
+   return waddch(win, ch);
+}
+
+
+/*
+  The insch, winsch, mvinsch and mvwinsch routines insert the
+  character ch before the character under the cursor.  All
+  characters to the right of the cursor are moved one space to the
+  right, with the possibility of the rightmost character on the
+  line being lost.  The cursor position does not change.
+*/
+int winsch( WINDOW *win, chtype c )
+{
+   int y = win->cy;
+   int x = win->cx;
+
+   if ((x >= win->width) || (y >= win->height) || !row_expand( win, y ))
+      return ERR;
+
+   split_wide( win, y, x );
+   memmove( win->lines[y] + x + 1, win->lines[y] + x,
+	    (win->width - x - 1) * sizeof(wchar_t) );
+   memmove( win->alines[y] + x + 1, win->alines[y] + x,
+	    (win->width - x - 1) * sizeof(attr_t) );
+   clip_wide( win, y );
+   put_cell( win, y, x, c );
+   touch_span( win, y, x, win->width - 1 );
+   return OK;
+}
+
+int mvwinsch(WINDOW *win, int y, int x, chtype ch)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return winsch(win, ch);
+}
+
+/*
+  These routines delete the character under the cursor; all
+  characters to the right of the cursor on the same line are moved
+  to the left one position and the last character on the line is
+  filled with a blank.  The cursor position does not change.
+*/
+int wdelch( WINDOW *win )
+{
+   int y = win->cy;
+   int x = win->cx;
+
+   if ((x >= win->width) || (y >= win->height) || !row_expand( win, y ))
+      return ERR;
+
+   split_wide( win, y, x );
+   memmove( win->lines[y] + x, win->lines[y] + x + 1,
+	    (win->width - x - 1) * sizeof(wchar_t) );
+   memmove( win->alines[y] + x, win->alines[y] + x + 1,
+	    (win->width - x - 1) * sizeof(attr_t) );
+   blank_span( win, y, win->width - 1, win->width - 1 );
+   touch_span( win, y, x, win->width - 1 );
+   return OK;
+}
+
+int mvwdelch(WINDOW *win, int y, int x)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return wdelch(win);
+}
+
+/*
+  These routines insert a character string (as many characters as
+  will fit on the line) before the character under the cursor.  All
+  characters to the right of the cursor are shifted right, with the
+  possibility of the rightmost characters on the line being lost.
+  The cursor position does not change.  The string is inserted with
+  a single shift of the row rather than one winsch per character.
+*/
+int winsnstr( WINDOW *win, const char *str, int n )
+{
+   int y = win->cy;
+   int x = win->cx;
+   int len, used, cells, i;
+   wchar_t *wstr, wc;
+   attr_t attrs = win->attributes;
+
+   if ((x >= win->width) || (y >= win->height) || !row_expand( win, y ))
+      return ERR;
+   if (str == NULL)
+      return OK;
+
+   /* decode what fits, counting the columns it takes */
+   wstr = malloc( (win->width - x) * sizeof(wchar_t) );
+   if (wstr == NULL)
+      return ERR;
+   for (len = 0, i = 0; (str[i] != '\0') && (i != n); i += used) {
+      wc = text_char( utf8_decode( str + i, (n < 0) ? -1 : n - i, &used ) );
+      cells = char_cells( wc );
+      if (len + cells > win->width - x)
+	 break;
+      if (cells == 0)
+	 continue;
+      wstr[len] = wc;
+      if (cells == 2)
+	 wstr[++len] = WIDE_FILLER;
+      len++;
+   }
+   if (len == 0) {
+      free( wstr );
+      return OK;
+   }
+
+   split_wide( win, y, x );
+   memmove( win->lines[y] + x + len, win->lines[y] + x,
+	    (win->width - x - len) * sizeof(wchar_t) );
+   memmove( win->alines[y] + x + len, win->alines[y] + x,
+	    (win->width - x - len) * sizeof(attr_t) );
+   memcpy( win->lines[y] + x, wstr, len * sizeof(wchar_t) );
+   for (i = x; i < x + len; i++)
+      win->alines[y][i] = attrs;
+   clip_wide( win, y );
+   free( wstr );
+   mark_blink( win, y, attrs );
+   touch_span( win, y, x, win->width - 1 );
+   return OK;
+}
+
+int winsstr( WINDOW *win, const char *str )
+{
+   return winsnstr( win, str, -1 );
+}
+
+int mvwinsstr(WINDOW *win, int y, int x, const char *str)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return winsstr(win, str);
+}
+
+/*
+  For positive n, the winsdelln routine inserts n lines into the
+  window above the current line, and the n bottom lines are lost.
+  For negative n, it deletes n lines (starting with the one under the
+  cursor) and moves the remaining lines up; the bottom n lines are
+  cleared.  The current cursor position remains the same.
+
+  No cells are copied: the row pointers from the cursor line down are
+  rotated, and the rows that come round the end are blanked.
+*/
+int winsdelln( WINDOW *win, int n )
+{
+   int top = win->cy;
+   int count, shift, row;
+   wchar_t **text_tmp;
+   attr_t **attrib_tmp;
+   bool *blink_tmp;
+   RUNS **runs_tmp;
+
+   if (top >= win->height)
+      return ERR;
+   count = win->height - top;
+   shift = (n < 0) ? -n : n;
+   if (shift == 0)
+      return OK;
+   if (shift > count)
+      shift = count;
+
+   text_tmp = malloc( shift * sizeof(wchar_t *) );
+   attrib_tmp = malloc( shift * sizeof(attr_t *) );
+   blink_tmp = malloc( shift * sizeof(bool) );
+   runs_tmp = malloc( shift * sizeof(RUNS *) );
+   if ((text_tmp == NULL) || (attrib_tmp == NULL) || (blink_tmp == NULL) ||
+       (runs_tmp == NULL)) {
+      free( text_tmp );
+      free( attrib_tmp );
+      free( blink_tmp );
+      free( runs_tmp );
+      return ERR;
+   }
+
+   if (n > 0) {
+      /* the bottom rows are reused as the inserted blank lines */
+      memcpy( text_tmp, win->lines + win->height - shift, shift * sizeof(wchar_t *) );
+      memcpy( attrib_tmp, win->alines + win->height - shift, shift * sizeof(attr_t *) );
+      memcpy( blink_tmp, win->blinkrows + win->height - shift, shift * sizeof(bool) );
+      memmove( win->lines + top + shift, win->lines + top, (count - shift) * sizeof(wchar_t *) );
+      memmove( win->alines + top + shift, win->alines + top, (count - shift) * sizeof(attr_t *) );
+      memmove( win->blinkrows + top + shift, win->blinkrows + top, (count - shift) * sizeof(bool) );
+      memcpy( win->lines + top, text_tmp, shift * sizeof(wchar_t *) );
+      memcpy( win->alines + top, attrib_tmp, shift * sizeof(attr_t *) );
+      memcpy( win->blinkrows + top, blink_tmp, shift * sizeof(bool) );
+      if (win->runs != NULL) {
+	 memcpy( runs_tmp, win->runs + win->height - shift, shift * sizeof(RUNS *) );
+	 memmove( win->runs + top + shift, win->runs + top, (count - shift) * sizeof(RUNS *) );
+	 memcpy( win->runs + top, runs_tmp, shift * sizeof(RUNS *) );
+      }
+      for (row = top; row < top + shift; row++) {
+	 blank_span( win, row, 0, win->width - 1 );
+	 set_blink_row( win, row, FALSE );
+      }
+   } else {
+      /* the deleted rows are reused as the blank lines at the bottom */
+      memcpy( text_tmp, win->lines + top, shift * sizeof(wchar_t *) );
+      memcpy( attrib_tmp, win->alines + top, shift * sizeof(attr_t *) );
+      memcpy( blink_tmp, win->blinkrows + top, shift * sizeof(bool) );
+      memmove( win->lines + top, win->lines + top + shift, (count - shift) * sizeof(wchar_t *) );
+      memmove( win->alines + top, win->alines + top + shift, (count - shift) * sizeof(attr_t *) );
+      memmove( win->blinkrows + top, win->blinkrows + top + shift, (count - shift) * sizeof(bool) );
+      memcpy( win->lines + win->height - shift, text_tmp, shift * sizeof(wchar_t *) );
+      memcpy( win->alines + win->height - shift, attrib_tmp, shift * sizeof(attr_t *) );
+      memcpy( win->blinkrows + win->height - shift, blink_tmp, shift * sizeof(bool) );
+      if (win->runs != NULL) {
+	 memcpy( runs_tmp, win->runs + top, shift * sizeof(RUNS *) );
+	 memmove( win->runs + top, win->runs + top + shift, (count - shift) * sizeof(RUNS *) );
+	 memcpy( win->runs + win->height - shift, runs_tmp, shift * sizeof(RUNS *) );
+      }
+      for (row = win->height - shift; row < win->height; row++) {
+	 blank_span( win, row, 0, win->width - 1 );
+	 set_blink_row( win, row, FALSE );
+      }
+   }
+
+   free( text_tmp );
+   free( attrib_tmp );
+   free( blink_tmp );
+   free( runs_tmp );
+
+   /* every row from the cursor down now shows different content */
+   touch_rows( win, top, count );
+   return OK;
+}
+
+int winsertln( WINDOW *win )
+{
+   return winsdelln( win, 1 );
+}
+
+int wdeleteln( WINDOW *win )
+{
+   return winsdelln( win, -1 );
+}
+
+/*
+  The wborder routine draws a box around the edges of the window,
+  using ACS line-drawing characters for any argument that is 0.  Each
+  horizontal edge is written as one span with a single change-tracking
+  update; the side edges touch each interior row once.
+*/
+int wborder(WINDOW *win, chtype ls, chtype rs, chtype ts, chtype bs,
+	    chtype tl, chtype tr, chtype bl, chtype br)
+{
+   int right = win->width - 1;
+   int bottom = win->height - 1;
+   int row;
+
+   if ((win->width < 2) || (win->height < 2))
+      return ERR;
+
+   if (ls == 0) ls = ACS_VLINE;
+   if (rs == 0) rs = ACS_VLINE;
+   if (ts == 0) ts = ACS_HLINE;
+   if (bs == 0) bs = ACS_HLINE;
+   if (tl == 0) tl = ACS_ULCORNER;
+   if (tr == 0) tr = ACS_URCORNER;
+   if (bl == 0) bl = ACS_LLCORNER;
+   if (br == 0) br = ACS_LRCORNER;
+
+   put_cell( win, 0, 0, tl );
+   fill_row( win, 0, 1, right - 1, ts );
+   put_cell( win, 0, right, tr );
+   touch_span( win, 0, 0, right );
+
+   put_cell( win, bottom, 0, bl );
+   fill_row( win, bottom, 1, right - 1, bs );
+   put_cell( win, bottom, right, br );
+   touch_span( win, bottom, 0, right );
+
+   for (row = 1; row < bottom; row++) {
+      put_cell( win, row, 0, ls );
+      put_cell( win, row, right, rs );
+      touch_span( win, row, 0, right );
+   }
+   return OK;
+}
+
+int box(WINDOW *win, chtype verch, chtype horch)
+{
+   return wborder(win, verch, verch, horch, horch, 0, 0, 0, 0);
+}
+
+/*
+  whline draws a line of at most n copies of ch to the right of the
+  cursor, and wvline the same downwards.  The cursor does not move.
+*/
+int whline(WINDOW *win, chtype ch, int n)
+{
+   int x1;
+
+   if ((win->cy >= win->height) || (win->cx >= win->width) || (n < 0))
+      return ERR;
+   if (ch == 0)
+      ch = ACS_HLINE;
+
+   x1 = win->cx + n - 1;
+   if (x1 >= win->width)
+      x1 = win->width - 1;
+   fill_row( win, win->cy, win->cx, x1, ch );
+   touch_span( win, win->cy, win->cx, x1 );
+   return OK;
+}
+
+int wvline(WINDOW *win, chtype ch, int n)
+{
+   int row;
+
+   if ((win->cy >= win->height) || (win->cx >= win->width) || (n < 0))
+      return ERR;
+   if (ch == 0)
+      ch = ACS_VLINE;
+
+   for (row = win->cy; (row < win->cy + n) && (row < win->height); row++) {
+      put_cell( win, row, win->cx, ch );
+      touch_span( win, row, win->cx, win->cx );
+   }
+   return OK;
+}
+
+int mvwhline(WINDOW *win, int y, int x, chtype ch, int n)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return whline(win, ch, n);
+}
+
+int mvwvline(WINDOW *win, int y, int x, chtype ch, int n)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return wvline(win, ch, n);
+}
+
+int waddnstr( WINDOW *win, const char *string, int n)
+{
+   const char * stringg;
+   int count, used;
+   wchar_t wc;
+
+   if ((string == NULL) || (n == 0))
+      return OK;
+
+   /* n counts bytes; a sequence cut short by it is taken byte by byte */
+   for ( stringg = string, count = 0; 
+	 ((*stringg != '\0') && (count != n)); 
+	 stringg += used, count += used ) {
+      wc = utf8_decode( stringg, (n < 0) ? -1 : n - count, &used );
+      if (add_wchar(win, wc, win->attributes) == ERR)
+	 return ERR;
+   }
+   return OK;
+}
+
+/*
+  These routines write the characters of the (null-terminated)
+  character string str on the given window.  It is similar to
+  calling wad- dch once for each character in the string.  The
+  four routines with n as the last argument write at most n
+  characters.  If n is -1, then the entire string will be added,
+  up to the maximum number of characters that will fit on the
+  line, or until a terminating null is reached.
+*/
+
+int waddstr( WINDOW *win, const char *str)
+{
+   return waddnstr( win, str, -1 );
+}
+
+int mvwaddstr(WINDOW *win, int y, int x, const char *str)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return waddstr(win, str);
+}
+	
+int mvwaddnstr(WINDOW *win, int y, int x, const char *str, int n)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return waddnstr(win, str, n);
+}
+
+/*
+  setcchar fills in wcval from the wide string wch, of which up to
+  CCHARW_MAX characters are kept, and the attributes and colour pair
+  given.  opts is reserved and must be NULL.
+*/
+int setcchar(cchar_t *wcval, const wchar_t *wch, attr_t attrs,
+	     short color_pair, void *opts)
+{
+   int i;
+
+   if ((wcval == NULL) || (wch == NULL) || (opts != NULL))
+      return ERR;
+   for (i = 0; (i < CCHARW_MAX) && (wch[i] != L'\0'); i++)
+      wcval->chars[i] = wch[i];
+   for (; i < CCHARW_MAX; i++)
+      wcval->chars[i] = L'\0';
+   wcval->attr = (attrs & A_ATTRIBUTES) | COLOR_PAIR( color_pair );
+   return OK;
+}
+
+/*
+  The add_wch family puts the complex character wch at the cursor
+  and advances it, like waddch; a double-width character takes two
+  columns.  Only the spacing character is drawn.
+*/
+int wadd_wch(WINDOW *win, const cchar_t *wch)
+{
+   attr_t attrs = win->attributes | (wch->attr & A_ATTRIBUTES);
+
+   if (wch->attr & A_COLOR)
+      attrs = (attrs & ~A_COLOR) | (wch->attr & A_COLOR);
+   return add_wchar( win, wch->chars[0], attrs );
+}
+
+int mvwadd_wch(WINDOW *win, int y, int x, const cchar_t *wch)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return wadd_wch(win, wch);
+}
+
+/*
+  The addwstr family writes the wide string wstr like waddstr; the
+  routines with n write at most n characters, or all of them if n
+  is -1.
+*/
+int waddnwstr(WINDOW *win, const wchar_t *wstr, int n)
+{
+   int count;
+
+   if ((wstr == NULL) || (n == 0))
+      return OK;
+
+   for (count = 0; (wstr[count] != L'\0') && (count != n); count++) {
+      if (add_wchar(win, wstr[count], win->attributes) == ERR)
+	 return ERR;
+   }
+   return OK;
+}
+
+int waddwstr(WINDOW *win, const wchar_t *wstr)
+{
+   return waddnwstr(win, wstr, -1);
+}
+
+int mvwaddwstr(WINDOW *win, int y, int x, const wchar_t *wstr)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return waddwstr(win, wstr);
+}
+
+int mvwaddnwstr(WINDOW *win, int y, int x, const wchar_t *wstr, int n)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return waddnwstr(win, wstr, n);
+}
+
+int vw_printw(WINDOW *win,  const char *fmt, va_list arglist)
+{
+   static char buffer[2048];
+
+   memset(buffer, 0, 2048 * sizeof(char));
+   vsnprintf(buffer, 2047, fmt, arglist);
+   waddstr(win, buffer);
+   return OK;
+}
+
+int wprintw(WINDOW *win, const char *fmt, ...)
+{
+   va_list params;
+   int result;
+
+   va_start(params, fmt);
+   result = vw_printw(win, fmt, params);
+   va_end(params);
+   return result;
+}
+
+int mvwprintw(WINDOW *win, int y, int x, const char *fmt, ...)
+{
+   va_list params;
+   int result;
+
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   va_start(params, fmt);
+   result = vw_printw(win, fmt, params);
+   va_end(params);
+   return result;
+
+}
+
+/*
+  wait_event waits in SDL_WaitEvent.  SDL 1.2 cannot block on the
+  display connection: SDL_WaitEvent is itself a loop of SDL_PumpEvents
+  and SDL_Delay(10), so a key may be seen up to WAIT_SLICE_MS after it
+  comes, but an idle wait wakes a hundred times a second rather than
+  a thousand.  A wait with a deadline starts a one-shot timer that
+  posts a WAKE_EVENT, tagged with the wait's serial number; a wake-up
+  from an earlier wait's timer that comes late is dropped, and one
+  that comes early has the timer started again.  SDL 1.2's timers
+  tick every WAIT_SLICE_MS too, so the timer is set to go off that
+  long before the deadline and the rest is slept out with SDL_Delay,
+  which ends the wait on time.  While a stream has viewers to serve
+  the wait polls instead, sleeping SINK_POLL_MS between looks, as they
+  need pumping whether or not a key comes.  Returns 1 with the event
+  filled in, or 0 once ms milliseconds have passed without one (ms < 0
+  waits forever).
+*/
+#define WAKE_EVENT (2)		/* SDL_USEREVENT code a wait's timer posts */
+#define WAIT_SLICE_MS (10)	/* SDL 1.2's event wait and timer step */
+#define SINK_POLL_MS (1)
+
+static Uint32 wait_serial = 0;	/* of the last wait with a deadline */
+
+/* runs in SDL's timer thread: wake the wait param is the serial of,
+ * once */
+static Uint32 wake_callback(Uint32 interval, void *param)
+{
+   SDL_Event event;
+
+   event.type = SDL_USEREVENT;
+   event.user.code = WAKE_EVENT;
+   event.user.data1 = param;
+   event.user.data2 = NULL;
+   SDL_PushEvent( &event );
+   return 0;
+}
+
+/* whether a sink needs pumping while the screen waits for input */
+static bool sinks_busy(void)
+{
+#ifdef SDL_CURSES_STREAM
+   return SP->stream != NULL;
+#else
+   return FALSE;
+#endif
+}
+
+static int wait_event(SDL_Event *event, int ms)
+{
+   Uint32 deadline = SDL_GetTicks() + ms;
+   Uint32 serial = ++wait_serial;
+   SDL_TimerID timer = NULL;
+   Sint32 left;
+
+   for (;;) {
+      SDL_PumpEvents();
+      if (SDL_PeepEvents( event, 1, SDL_GETEVENT, SDL_ALLEVENTS ) > 0) {
+	 if ((event->type != SDL_USEREVENT) || (event->user.code != WAKE_EVENT))
+	    break;
+	 /* this wait's timer has fired and is gone */
+	 if (event->user.data1 == (void *) (size_t) serial)
+	    timer = NULL;
+	 continue;
+      }
+      left = (Sint32) (deadline - SDL_GetTicks());
+      if ((ms >= 0) && (left <= 0)) {
+	 if (timer != NULL)
+	    SDL_RemoveTimer( timer );
+	 return 0;
+      }
+      if (sinks_busy()) {
+	 sink_idle();
+	 SDL_Delay( SINK_POLL_MS );
+	 continue;
+      }
+      if ((ms >= 0) && (left <= WAIT_SLICE_MS)) {
+	 SDL_Delay( left );
+	 continue;
+      }
+      if ((ms >= 0) && (timer == NULL)) {
+	 timer = SDL_AddTimer( left - WAIT_SLICE_MS, wake_callback, (void *) (size_t) serial );
+	 if (timer == NULL) {
+	    SDL_Delay( SINK_POLL_MS );
+	    continue;
+	 }
+      }
+      SDL_WaitEvent( NULL );
+   }
+   if (timer != NULL)
+      SDL_RemoveTimer( timer );
+   return 1;
+}
+
+/* how long a read from win may block: half-delay mode overrides the
+ * window's own setting */
+static int input_delay(WINDOW *win)
+{
+   if (halfdelay_tenths > 0)
+      return halfdelay_tenths * 100;
+   return win->delay;
+}
+
+/* milliseconds left until deadline for a read that started with the
+ * given delay; negative delays never run out */
+static int time_left(int delay, Uint32 deadline)
+{
+   Sint32 remaining;
+
+   if (delay <= 0)
+      return delay;
+   remaining = (Sint32) (deadline - SDL_GetTicks());
+   return (remaining < 0) ? 0 : remaining;
+}
+
+/* the code wgetch returns for a key, or ERR for keys that produce
+   nothing, such as the modifiers on their own; *fkey is set if the
+   code is a function key rather than a character */
+static int translate_key(WINDOW *win, SDL_keysym *keysym, bool *fkey)
+{
+   int code = ERR;
+
+   *fkey = TRUE;
+
+   switch ( keysym->sym ) 
+   {
+      case SDLK_UP: 
+      case SDLK_DOWN: 
+      case SDLK_LEFT: 
+      case SDLK_RIGHT: 
+      case SDLK_PAGEDOWN: 
+      case SDLK_PAGEUP: 
+      case SDLK_HOME: 
+      case SDLK_END: 
+      case SDLK_INSERT:
+      case SDLK_F1:
+      case SDLK_F2:
+      case SDLK_F3:
+      case SDLK_F4:
+      case SDLK_F5:
+      case SDLK_F6:
+      case SDLK_F7:
+      case SDLK_F8:
+      case SDLK_F9:
+      case SDLK_F10:
+      case SDLK_F11:
+      case SDLK_F12:
+      case SDLK_F13:
+      case SDLK_F14:
+      case SDLK_F15:
+      {
+	 code = keysym->sym;
+	 break;
+      }
+
+      case SDLK_KP0:
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '0';
+	 }
+	 break;
+
+      case SDLK_KP1:
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '1';
+	 }
+	 break;
+
+      case SDLK_KP3:
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '3';
+	 }
+	 break;
+
+      case SDLK_KP5:
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '5';
+	 }
+	 break;
+
+      case SDLK_KP7:
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '7';
+	 }
+	 break;
+
+      case SDLK_KP9:
+      {
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '9';
+	 }
+	 break;
+      }
+
+      case SDLK_KP2:
+      {
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '2';
+	    break;
+	 }
+	 if (win->keypad_on)
+	    code = SDLK_DOWN;
+	 break;
+      }
+      case SDLK_KP6:
+      {
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '6';
+	    break;
+	 } 
+	 if (win->keypad_on) {
+	    code = SDLK_RIGHT;
+	 }
+	 break;
+      }
+      case SDLK_KP4:
+      {
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '4'; 
+	    break;
+	 }
+	 if (win->keypad_on)
+	    code = SDLK_LEFT;
+	 break;
+      }
+
+      case SDLK_KP8:
+      {
+	 code = keysym->sym;
+	 if (keysym->mod & KMOD_NUM) {
+	    code = '8';
+	    break;
+	 }
+	 if (win->keypad_on)
+	    code = SDLK_UP;
+	 break;
+      }
+
+      default:
+	 code = keysym->unicode ? keysym->unicode : ERR;
+	 *fkey = FALSE;
+	 break;
+   } /* switch */
+
+   /* the keypad digits with num lock on */
+   if (code < 256)
+      *fkey = FALSE;
+
+   /* bodge.. */
+   if (code == '\r')
+      code = '\n';
+   return code;
+}
+
+/* with coalescing on, decide whether a repeat of sym is stale: any
+   repeats of it queued directly behind are folded into this one, and
+   if the key has been released further down the queue the repeat is
+   dropped as well */
+static bool stale_repeat(SDLKey sym)
+{
+   SDL_Event events[ 32 ];
+   int n, i;
+
+   while ((SDL_PeepEvents( events, 1, SDL_PEEKEVENT, SDL_ALLEVENTS ) > 0) &&
+	  (events[0].type == SDL_KEYDOWN) && (events[0].key.keysym.sym == sym)) {
+      SDL_PeepEvents( events, 1, SDL_GETEVENT, SDL_ALLEVENTS );
+      key_repeats_dropped++;
+   }
+
+   n = SDL_PeepEvents( events, 32, SDL_PEEKEVENT, SDL_KEYUPMASK );
+   for (i = 0; i < n; i++) {
+      if (events[i].key.keysym.sym == sym) {
+	 key_repeats_dropped++;
+	 return TRUE;
+      }
+   }
+   return FALSE;
+}
+
+/*
+  A screen on a terminal reads its keys from the terminal's input,
+  which is left unbuffered and unechoed by the mode it is put in; the
+  library edits lines itself, as it does with the keyboard.  The
+  escape sequences of xterm and the Linux console for the cursor,
+  editing and function keys are made into the same codes as the SDL
+  keys, with their modifiers; an ESC is taken for the key itself if
+  nothing follows it within TTY_ESCAPE_MS.  A change in the
+  terminal's size is reported as KEY_RESIZE.
+*/
+#ifdef SDL_CURSES_TTY
+
+/* the key an escape sequence ending in final, with parameter n, is
+ * for, ERR if it is none */
+static int tty_escape_key(int final, int n, bool *fkey)
+{
+   *fkey = TRUE;
+   switch (final) {
+      case 'A': return KEY_UP;
+      case 'B': return KEY_DOWN;
+      case 'C': return KEY_RIGHT;
+      case 'D': return KEY_LEFT;
+      case 'H': return KEY_HOME;
+      case 'F': return KEY_END;
+      case 'P': return KEY_F(1);
+      case 'Q': return KEY_F(2);
+      case 'R': return KEY_F(3);
+      case 'S': return KEY_F(4);
+      case 'Z':
+	 *fkey = FALSE;
+	 return '\t';
+      case '~':
+	 break;
+      default:
+	 return ERR;
+   }
+   switch (n) {
+      case 1: case 7: return KEY_HOME;
+      case 2: return KEY_IC;
+      case 3:
+	 /* as the keyboard's delete key */
+	 *fkey = FALSE;
+	 return 127;
+      case 4: case 8: return KEY_END;
+      case 5: return KEY_PPAGE;
+      case 6: return KEY_NPAGE;
+      case 11: case 12: case 13: case 14: case 15: return KEY_F(n - 10);
+      case 17: case 18: case 19: case 20: case 21: return KEY_F(n - 11);
+      case 23: case 24: case 25: case 26: return KEY_F(n - 12);
+      case 28: return KEY_F(15);
+   }
+   return ERR;
+}
+
+/* make a key of the first bytes of s, returning how many it took, or
+ * 0 if they are the start of something longer; if the rest is not
+ * coming, they are taken as they are.  key->code is ERR for a
+ * sequence that is no key. */
+static int tty_parse_key(const Uint8 *s, int n, bool rest_due, KEY_EVENT *key)
+{
+   int i, param[ 2 ] = { 0, 0 }, np = 0, len;
+   Uint32 c;
+
+   key->fkey = FALSE;
+   key->mod = KMOD_NONE;
+   if (n == 0)
+      return 0;
+
+   if (s[0] == 0x1b) {
+      if (n == 1) {
+	 key->code = 27;
+	 return rest_due ? 0 : 1;
+      }
+      if ((s[1] == '[') || (s[1] == 'O')) {
+	 for (i = 2; (i < n) && (((s[i] >= '0') && (s[i] <= '9')) || (s[i] == ';')); i++) {
+	    if (s[i] == ';')
+	       np++;
+	    else if (np < 2)
+	       param[ np ] = param[ np ] * 10 + s[i] - '0';
+	 }
+	 if (i == n) {
+	    if (rest_due)
+	       return 0;
+	    key->code = 27;
+	    return 1;
+	 }
+	 key->code = tty_escape_key( s[i], param[0], &key->fkey );
+	 /* xterm's modifiers: 1 plus shift 1, alt 2, control 4 */
+	 if (param[1] > 1) {
+	    if ((param[1] - 1) & 1)
+	       key->mod |= KMOD_SHIFT;
+	    if ((param[1] - 1) & 2)
+	       key->mod |= KMOD_ALT;
+	    if ((param[1] - 1) & 4)
+	       key->mod |= KMOD_CTRL;
+	 }
+	 if (s[i] == 'Z')
+	    key->mod |= KMOD_SHIFT;
+	 return i + 1;
+      }
+      /* alt and a key */
+      i = tty_parse_key( s + 1, n - 1, rest_due, key );
+      if (i == 0)
+	 return 0;
+      key->mod |= KMOD_ALT;
+      return i + 1;
+   }
+
+   /* UTF-8, bytes that are not taken as Latin-1 */
+   c = s[0];
+   len = (c >= 0xf0) ? 4 : (c >= 0xe0) ? 3 : (c >= 0xc0) ? 2 : 1;
+   if (len > n) {
+      if (rest_due)
+	 return 0;
+      len = 1;
+   }
+   if (len > 1) {
+      c &= 0x3f >> (len - 1);
+      for (i = 1; i < len; i++) {
+	 if ((s[i] & 0xc0) != 0x80) {
+	    c = s[0];
+	    len = 1;
+	    break;
+	 }
+	 c = (c << 6) | (s[i] & 0x3f);
+      }
+   }
+   key->code = (c == '\r') ? '\n' : (int) c;
+   return len;
+}
+
+static bool tty_input_pending(TTY *t)
+{
+   struct pollfd p;
+
+   p.fd = t->in;
+   p.events = POLLIN;
+   return (t->input_len > 0) || (poll( &p, 1, 0 ) > 0);
+}
+
+/* read_key for a screen on a terminal */
+static bool tty_read_key(TTY *t, int ms, KEY_EVENT *key)
+{
+   Uint32 deadline = SDL_GetTicks() + ms;
+   struct pollfd p;
+   int lines, cols, wait, n;
+
+   for (;;) {
+      if (tty_winched) {
+	 tty_winched = 0;
+	 if (tty_winsize( t, &lines, &cols ) && ((lines != LINES) || (cols != COLS))) {
+	    resizeterm( lines, cols );
+	    key->code = KEY_RESIZE;
+	    key->fkey = TRUE;
+	    key->mod = KMOD_NONE;
+	    break;
+	 }
+      }
+
+      n = tty_parse_key( t->input, t->input_len, (t->input_len > 0) &&
+			 ((Sint32) (SDL_GetTicks() - t->input_ticks) < TTY_ESCAPE_MS), key );
+      if (n > 0) {
+	 t->input_len -= n;
+	 memmove( t->input, t->input + n, t->input_len );
+	 if (key->code == ERR)
+	    continue;
+	 break;
+      }
+
+      wait = time_left( ms, deadline );
+      if (wait == 0)
+	 return FALSE;
+      if (t->input_len > 0)
+	 wait = TTY_ESCAPE_MS;
+      else if (SP->stream != NULL)
+	 wait = ((wait < 0) || (wait > TTY_POLL_MS)) ? TTY_POLL_MS : wait;
+      sink_idle();
+      p.fd = t->in;
+      p.events = POLLIN;
+      if ((poll( &p, 1, wait ) > 0) && (t->input_len < (int) sizeof(t->input))) {
+	 n = read( t->in, t->input + t->input_len, sizeof(t->input) - t->input_len );
+	 if ((n == 0) || ((n < 0) && (errno != EINTR) && (errno != EAGAIN)))
+	    return FALSE;		/* the end of the input */
+	 if (n > 0) {
+	    t->input_len += n;
+	    t->input_ticks = SDL_GetTicks();
+	 }
+      }
+   }
+
+   key->ticks = SDL_GetTicks();
+   if (SP->record != NULL)
+      record_key( key );
+   return TRUE;
+}
+
+#endif /* SDL_CURSES_TTY */
+
+/* wait up to ms for the next keypress and translate it, FALSE if
+   none arrived in time */
+static bool read_key(WINDOW *win, int ms, KEY_EVENT *key)
+{
+   SDL_Event event;
+   Uint32 deadline = SDL_GetTicks() + ms;
+   int code;
+   bool repeat, fkey;
+
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL) {
+      pack_idle();
+      return tty_read_key( SP->tty, ms, key );
+   }
+#endif
+   /* only the display's screen has a keyboard */
+   if (!SP->display)
+      return FALSE;
+   pack_idle();
+   for (;;) {
+      if (!wait_event( &event, time_left( ms, deadline ) ))
+	 return FALSE;
+
+      if ( event.type == SDL_QUIT ) {
+	 TTF_Quit();
+	 SDL_Quit();
+	 exit( 0 );
+      }
+
+      if ( event.type == SDL_KEYUP ) {
+	 key_held[ event.key.keysym.sym ] = FALSE;
+	 continue;
+      }
+
+      if (( event.type == SDL_USEREVENT ) && ( event.user.code == BLINK_EVENT )) {
+	 blink_update();
+	 continue;
+      }
+
+      if ( event.type == SDL_VIDEORESIZE ) {
+	 /* a drag sends a stream of these: only the last one counts */
+	 while (SDL_PeepEvents( &event, 1, SDL_GETEVENT, SDL_VIDEORESIZEMASK ) > 0)
+	    ;
+	 resize_to_fit( event.resize.w, event.resize.h );
+	 key->code = KEY_RESIZE;
+	 key->fkey = TRUE;
+	 key->mod = KMOD_NONE;
+	 key->ticks = SDL_GetTicks();
+	 if (SP->record != NULL)
+	    record_key( key );
+	 return TRUE;
+      }
+
+      if ( event.type == SDL_VIDEOEXPOSE ) {
+	 SDL_Rect all;
+
+	 all.x = 0;
+	 all.y = 0;
+	 all.w = screen_width;
+	 all.h = screen_height;
+	 present_rects( 1, &all );
+	 continue;
+      }
+
+      if ( event.type != SDL_KEYDOWN )
+	 continue;
+
+      repeat = key_held[ event.key.keysym.sym ];
+      key_held[ event.key.keysym.sym ] = TRUE;
+      if (repeat && key_coalesce && stale_repeat( event.key.keysym.sym ))
+	 continue;
+
+      code = translate_key( win, &event.key.keysym, &fkey );
+      if (code == ERR)
+	 continue;
+
+      key->code = code;
+      key->fkey = fkey;
+      key->mod = event.key.keysym.mod;
+      key->ticks = SDL_GetTicks();
+      if (SP->record != NULL)
+	 record_key( key );
+      return TRUE;
+   }
+}
+
+static bool is_erase_key(int code)
+{
+   return (code == '\b') || (code == 127);
+}
+
+static void echo_key(WINDOW *win, const KEY_EVENT *key)
+{
+   int y = win->cy;
+   int x = win->cx;
+
+   if ((!echo_on) || key->fkey || (key->code < ' ') || (key->code == 127))
+      return;
+   add_wchar( win, (wchar_t) key->code, win->attributes );
+   refresh_cell( win, y, x );
+}
+
+/* echo the removal of the last character typed, both columns of a
+   double-width one */
+static void echo_erase(WINDOW *win)
+{
+   int span = 1;
+
+   if ((!echo_on) || (win->cx == 0))
+      return;
+   win->cx--;
+   if (win->cy < win->height) {
+      if ((win->cx < win->width) && is_covered( win, win->cy, win->cx )) {
+	 win->cx--;
+	 span = 2;
+      }
+      blank_span( win, win->cy, win->cx, win->cx + span - 1 );
+      touch_span( win, win->cy, win->cx, win->cx + span - 1 );
+      refresh_cell( win, win->cy, win->cx );
+      if (span == 2)
+	 refresh_cell( win, win->cy, win->cx + 1 );
+   }
+}
+
+/* queue a key typed in nocbreak mode, editing the pending line */
+static void cooked_key(WINDOW *win, const KEY_EVENT *key)
+{
+   if (is_erase_key( key->code )) {
+      if (key_unpush())
+	 echo_erase( win );
+      return;
+   }
+
+   if (!key_push( key ))
+      return;
+   echo_key( win, key );
+   /* a full queue is handed over as it is, or it would never drain */
+   if ((key->code == '\n') || (SP->key_count == MAX_INPUT_PENDING))
+      SP->key_ready = SP->key_count;
+}
+
+/*
+  The getch, wgetch, mvgetch and mvwgetch, routines read a
+  character from the window.  In no-delay mode, if no input is
+  waiting, the value ERR is returned.  In delay mode, the program
+  waits until the system passes text through to the program.
+  Depending on the setting of cbreak, this is after one
+  character (cbreak mode), or after the first newline (nocbreak
+  mode).  In half-delay mode, the pro- gram waits until a
+  character is typed or the specified timeout has been reached.
+*/
+
+
+/* the next key for wgetch or wget_wch, FALSE if there was none in
+   time */
+static bool get_key(WINDOW *win, KEY_EVENT *key)
+{
+   int delay = input_delay( win );
+   Uint32 deadline = SDL_GetTicks() + delay;
+
+   while ( SP->key_ready == 0 ) {
+
+      if (!read_key( win, time_left( delay, deadline ), key ))
+	 return FALSE;
+
+      /* a resize is reported at once, even in the middle of a line */
+      if (cbreak_on || (key->code == KEY_RESIZE)) {
+	 echo_key( win, key );
+	 return TRUE;
+      }
+      cooked_key( win, key );
+   }
+
+   key_pop( key );
+   return TRUE;
+}
+
+int wgetch(WINDOW *win) 
+{
+   KEY_EVENT key;
+
+   if (!get_key( win, &key ))
+      return ERR;
+   return key.code;
+}
+
+/*
+  wget_wch reads a key like wgetch, storing it in *wch.  It returns
+  KEY_CODE_YES for a function key and OK for a character, so that a
+  character above 255 is not taken for one of the KEY_ codes.
+*/
+int wget_wch(WINDOW *win, wint_t *wch)
+{
+   KEY_EVENT key;
+
+   if (!get_key( win, &key ))
+      return ERR;
+   *wch = key.code;
+   return key.fkey ? KEY_CODE_YES : OK;
+}
+
+int mvwget_wch(WINDOW *win, int y, int x, wint_t *wch)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return wget_wch(win, wch);
+}
+
+/*
+  The ungetch routine places ch back onto the input queue to be
+  returned by the next call to wgetch.
+*/
+int ungetch(int ch)
+{
+   KEY_EVENT key;
+
+   key.code = ch;
+   key.fkey = (ch > 255);
+   key.mod = KMOD_NONE;
+   key.ticks = SDL_GetTicks();
+   return key_push_front( &key ) ? OK : ERR;
+}
+
+/*
+  The flushinp routine throws away any typeahead that has been typed
+  by the user and has not yet been read by the program.
+*/
+int flushinp(void)
+{
+   SDL_Event events[ 16 ];
+
+   if (SP == NULL)
+      return ERR;
+   SP->key_head = 0;
+   SP->key_count = 0;
+   SP->key_ready = 0;
+#ifdef SDL_CURSES_TTY
+   if (SP->tty != NULL) {
+      SP->tty->input_len = 0;
+      tcflush( SP->tty->in, TCIFLUSH );
+      return OK;
+   }
+#endif
+   if (!SP->display)
+      return OK;
+   memset( key_held, 0, sizeof(key_held) );
+   SDL_PumpEvents();
+   while (SDL_PeepEvents( events, 16, SDL_GETEVENT,
+			  SDL_KEYDOWNMASK | SDL_KEYUPMASK ) > 0)
+      ;
+   return OK;
+}
+
+/*
+  With typeahead enabled (fd >= 0), wrefresh leaves the screen alone
+  while keys are waiting to be read, so that a program which is
+  behind the user does not draw frames that are already out of date.
+  The changes are kept and drawn by the first refresh once the input
+  has been read.  There is no file descriptor underneath SDL, so fd
+  only selects on (>= 0) or off (-1, the default).
+*/
+int typeahead(int fd)
+{
+   if (SP == NULL)
+      return ERR;
+   SP->typeahead_fd = fd;
+   return OK;
+}
+
+/*
+  keyrepeat sets how long a key is held before it starts repeating and
+  the interval between repeats, both in milliseconds; a delay of 0
+  turns auto-repeat off.  It may be called before initscr.
+
+  keycoalesce turns repeat coalescing on or off (off by default).
+  When a program falls behind, SDL keeps queueing a repeat every
+  interval for as long as a key is held, and each of them would
+  otherwise be read in turn long after the key was let go.  With
+  coalescing on, a run of queued repeats of the same key is read as
+  one, and repeats of a key already released further down the queue
+  are dropped.  keyrepeats_dropped returns the number of repeats
+  thrown away so far.
+*/
+int keyrepeat(int delay, int interval)
+{
+   if ((delay < 0) || (interval < 0))
+      return ERR;
+   key_repeat_delay = delay;
+   key_repeat_interval = interval;
+   if (display_screen != NULL)
+      return SDL_EnableKeyRepeat( delay, interval ) == 0 ? OK : ERR;
+   return OK;
+}
+
+int keycoalesce(bool bf)
+{
+   key_coalesce = bf;
+   return OK;
+}
+
+unsigned long keyrepeats_dropped(void)
+{
+   return key_repeats_dropped;
+}
+
+/*
+  wgetnstr reads a whole line into str as UTF-8, at most n bytes (n <
+  0 allows MAX_INPUT_PENDING - 1) and only whole characters, handling
+  erase and echo itself as the keys are read rather than through
+  wgetch one character at a time.  Keys already queued are used
+  first.  The newline is not stored.
+  If the window's delay runs out first, the partial line is stored
+  and ERR returned.
+*/
+int wgetnstr(WINDOW *win, char *str, int n)
+{
+   KEY_EVENT key;
+   int delay = input_delay( win );
+   Uint32 deadline = SDL_GetTicks() + delay;
+   Uint8 utf8[ 4 ];
+   int len = 0;
+   int used;
+   bool typed;
+
+   if ((n < 0) || (n > MAX_INPUT_PENDING - 1))
+      n = MAX_INPUT_PENDING - 1;
+
+   for (;;) {
+      typed = FALSE;
+      if (SP->key_count > 0) {
+	 key_pop( &key );
+      } else {
+	 if (!read_key( win, time_left( delay, deadline ), &key )) {
+	    str[ len ] = '\0';
+	    return ERR;
+	 }
+	 typed = TRUE;
+      }
+
+      if (key.code == '\n')
+	 break;
+
+      if (is_erase_key( key.code )) {
+	 if (len > 0) {
+	    /* the whole of the last character goes */
+	    do
+	       len--;
+	    while ((len > 0) && ((str[ len ] & 0xC0) == 0x80));
+	    echo_erase( win );
+	 }
+      } else if (!key.fkey && (key.code >= ' ') && (key.code <= 0x10FFFF)) {
+	 used = utf8_encode( key.code, utf8 );
+	 if (len + used <= n) {
+	    memcpy( str + len, utf8, used );
+	    len += used;
+	    if (typed)
+	       echo_key( win, &key );
+	 }
+      }
+   }
+
+   str[ len ] = '\0';
+   return OK;
+}
+
+int wgetstr(WINDOW *win, char *str)
+{
+   return wgetnstr(win, str, -1);
+}
+
+int mvwgetnstr(WINDOW *win, int y, int x, char *str, int n)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return wgetnstr(win, str, n);
+}
+
+int cbreak(void)
+{
+   cbreak_on = TRUE;
+   halfdelay_tenths = 0;
+   /* a partly typed line is readable straight away */
+   SP->key_ready = SP->key_count;
+   globals_changed();
+   return OK;
+}
+
+int nocbreak(void)
+{
+   cbreak_on = FALSE;
+   halfdelay_tenths = 0;
+   globals_changed();
+   return OK;
+}
+
+int halfdelay(int tenths)
+{
+   if ((tenths < 1) || (tenths > 255))
+      return ERR;
+   cbreak_on = TRUE;
+   SP->key_ready = SP->key_count;
+   halfdelay_tenths = tenths;
+   globals_changed();
+   return OK;
+}
+
+int crmode(void)
+{
+   return cbreak();
+}
+
+int nodelay(WINDOW *win, bool bf)
+{
+   win->delay = bf ? 0 : -1;
+   return OK;
+}
+
+void wtimeout(WINDOW *win, int delay)
+{
+   win->delay = (delay < 0) ? -1 : delay;
+}
+
+void timeout(int delay)
+{
+   wtimeout(stdscr, delay);
+}
+
+int keypad(WINDOW *win, bool bf)
+{
+   win->keypad_on = bf;
+   return OK;
+}
+
+int mvwgetch(WINDOW *win, int y, int x)
+{
+   if (wmove(win, y, x) != OK)
+      return ERR;
+   return wgetch(win);
+}
+
+int refresh( void )
+{
+   return wrefresh(stdscr);
+}
+
+int move( int y, int x )
+{
+   return wmove(stdscr, y, x);
+}
+
+int getch(void)
+{
+   return wgetch(stdscr);
+}
+
+int get_wch(wint_t *wch)
+{
+   return wget_wch(stdscr, wch);
+}
+
+int mvget_wch(int y, int x, wint_t *wch)
+{
+   return mvwget_wch(stdscr, y, x, wch);
+}
+
+int getstr(char *str)
+{
+   return wgetnstr(stdscr, str, -1);
+}
+
+int getnstr(char *str, int n)
+{
+   return wgetnstr(stdscr, str, n);
+}
+
+int mvgetnstr(int y, int x, char *str, int n)
+{
+   return mvwgetnstr(stdscr, y, x, str, n);
+}
+
+int mvgetch(int y, int x)
+{
+   if(move(y,x) != OK)
+      return ERR;
+   return getch();
+}
+
+int addch(const chtype ch)
+{
+   return waddch(stdscr, ch);
+}
+
+int echochar(const chtype ch)
+{
+   return wechochar(stdscr, ch);
+}
+
+int mvaddch(int y, int x, const chtype ch)
+{
+   if (move(y,x) != OK)
+      return ERR;
+   return addch(ch);
+}
+
+int addstr(const char *str)
+{
+   return waddstr(stdscr, str);
+}
+
+int addnstr(const char *str, int n)
+{
+   return waddnstr(stdscr, str, n);
+}
+
+int mvaddstr(int y, int x, const char *str)
+{
+   return mvwaddstr(stdscr, y, x, str);
+}
+
+int mvaddnstr(int y, int x, const char *str, int n)
+{
+   return mvwaddnstr(stdscr, y, x, str, n);
+}
+
+int add_wch(const cchar_t *wch)
+{
+   return wadd_wch(stdscr, wch);
+}
+
+int mvadd_wch(int y, int x, const cchar_t *wch)
+{
+   return mvwadd_wch(stdscr, y, x, wch);
+}
+
+int addwstr(const wchar_t *wstr)
+{
+   return waddwstr(stdscr, wstr);
+}
+
+int addnwstr(const wchar_t *wstr, int n)
+{
+   return waddnwstr(stdscr, wstr, n);
+}
+
+int mvaddwstr(int y, int x, const wchar_t *wstr)
+{
+   return mvwaddwstr(stdscr, y, x, wstr);
+}
+
+int mvaddnwstr(int y, int x, const wchar_t *wstr, int n)
+{
+   return mvwaddnwstr(stdscr, y, x, wstr, n);
+}
+
+int insch(chtype ch)
+{
+   return winsch(stdscr, ch);
+}
+
+int mvinsch(int y, int x, chtype ch)
+{
+   return mvwinsch(stdscr, y, x, ch);
+}
+
+int delch(void)
+{
+   return wdelch(stdscr);
+}
+
+int mvdelch(int y, int x)
+{
+   return mvwdelch(stdscr, y, x);
+}
+
+int insstr(const char *str)
+{
+   return winsstr(stdscr, str);
+}
+
+int insnstr(const char *str, int n)
+{
+   return winsnstr(stdscr, str, n);
+}
+
+int mvinsstr(int y, int x, const char *str)
+{
+   return mvwinsstr(stdscr, y, x, str);
+}
+
+int insdelln(int n)
+{
+   return winsdelln(stdscr, n);
+}
+
+int insertln(void)
+{
+   return winsertln(stdscr);
+}
+
+int deleteln(void)
+{
+   return wdeleteln(stdscr);
+}
+
+int border(chtype ls, chtype rs, chtype ts, chtype bs,
+	   chtype tl, chtype tr, chtype bl, chtype br)
+{
+   return wborder(stdscr, ls, rs, ts, bs, tl, tr, bl, br);
+}
+
+int hline(chtype ch, int n)
+{
+   return whline(stdscr, ch, n);
+}
+
+int vline(chtype ch, int n)
+{
+   return wvline(stdscr, ch, n);
+}
+
+int mvhline(int y, int x, chtype ch, int n)
+{
+   return mvwhline(stdscr, y, x, ch, n);
+}
+
+int mvvline(int y, int x, chtype ch, int n)
+{
+   return mvwvline(stdscr, y, x, ch, n);
+}
+
+int printw(const char *fmt, ...)
+{
+   va_list params;
+   int result;
+
+   va_start(params, fmt);
+   result = vw_printw(stdscr, fmt, params);
+   va_end(params);
+   return result;
+
+}
+
+int mvprintw(int y, int x, const char *fmt, ...)
+{
+   va_list params;
+   int result;
+
+   if (wmove(stdscr, y, x) != OK)
+      return ERR;
+   va_start(params, fmt);
+   result = vw_printw(stdscr, fmt, params);
+   va_end(params);
    return result;
 
 }
 
-int mvprintw(int y, int x, const char *fmt, ...)
+/*
+       The start_color routine requires no arguments.  It must be
+       called if the programmer wants to use colors, and before any
+       other color manipulation routine is called.  It is good
+       practice to call this routine right after initscr.  start_color
+       initializes eight basic colors (black, red, green, yellow,
+       blue, magenta, cyan, and white), and two global variables,
+       COLORS and COLOR_PAIRS (respectively defining the maximum
+       number of colors and color-pairs the terminal can support).  It
+       also restores the colors on the terminal to the values they had
+       when the terminal was just turned on.
+
+       The init_pair routine changes the definition of a color-pair.
+       It takes three arguments: the number of the color-pair to be
+       changed, the foreground color number, and the background color
+       number.  For portable applications:
+
+       - The value of the first argument must be between 1 and
+            COLOR_PAIRS-1.
+
+       - The value of the second and third arguments must be between 0
+            and COLORS (the 0 color pair is wired to white on black
+            and cannot be changed).
+
+       If the color-pair was previously initialized, the screen is
+       refreshed and all occurrences of that color-pair are changed to
+       the new definition.
+
+       As an extension, ncurses allows you to set color pair 0 via the
+       assume_default_colors routine, or to specify the use of default
+       colors (color number -1) if you first invoke the
+       use_default_colors routine.
+
+       The init_color routine changes the definition of a color.  It
+       takes four arguments: the number of the color to be changed
+       followed by three RGB values (for the amounts of red, green,
+       and blue components).  The value of the first argument must be
+       between 0 and COLORS.  (See the section Colors for the default
+       color index.)  Each of the last three arguments must be a value
+       between 0 and 1000.  When init_color is used, all occurrences
+       of that color on the screen immediately change to the new
+       definition.
+
+       The has_colors routine requires no arguments.  It returns TRUE
+       if the terminal can manipulate colors; otherwise, it returns
+       FALSE.  This routine facilitates writing terminal-independent
+       programs.  For example, a programmer can use it to decide
+       whether to use color or some other video attribute.
+
+       The can_change_color routine requires no arguments.  It returns
+       TRUE if the terminal supports colors and can change their
+       definitions; other, it returns FALSE.  This routine facilitates
+       writing terminal-independent programs.
+
+       The color_content routine gives programmers a way to find the
+       intensity of the red, green, and blue (RGB) components in a
+       color.  It requires four arguments: the color number, and three
+       addresses of shorts for storing the information about the
+       amounts of red, green, and blue components in the given color.
+       The value of the first argument must be between 0 and COLORS.
+       The values that are stored at the addresses pointed to by the
+       last three arguments are between 0 (no component) and 1000
+       (maximum amount of component).
+
+       The pair_content routine allows programmers to find out what
+       colors a given color-pair consists of.  It requires three
+       arguments: the color-pair number, and two addresses of shorts
+       for storing the foreground and the background color numbers.
+       The value of the first argument must be between 1 and
+       COLOR_PAIRS-1.  The values that are stored at the addresses
+       pointed to by the second and third argu- ments are between 0
+       and COLORS.
+
+*/
+
+int start_color(void)
+{
+   color_pairs[0] = 0;  /* black */
+   color_pairs[1] = 7;  /* white */
+   color_pairs[2] = 0;  /* black */
+   color_pairs[3] = 7;  /* white */
+   backing_drop_all();
+   if ((SP != NULL) && (SP->record != NULL)) {
+      record_pair( 0 );
+      record_pair( 1 );
+   }
+   sink_palette();
+   globals_changed();
+
+   return OK;
+}
+
+bool has_colors(void)
+{
+   return TRUE;
+}
+
+bool can_change_color(void)
+{
+   return TRUE;
+}
+
+int init_pair(short pair, short f, short b)
+{
+/*   fprintf(stderr, "Set pair %d to %x %x \n\r", pair, f, b); */
+   if ((pair <= 0) || (pair >= COLOR_PAIRS))
+      return ERR;
+   color_pairs[pair * 2] = b;
+   color_pairs[pair * 2 + 1] = f;
+   backing_drop_all();
+   if ((SP != NULL) && (SP->record != NULL))
+      record_pair( pair );
+   sink_palette();
+   globals_changed();
+   return OK;
+}
+
+int pair_content(short pair, short *f, short *b)
+{
+   if ((pair <= 0) || (pair >= COLOR_PAIRS))
+      return ERR;
+   *f = color_pairs[pair * 2 + 1];
+   *b = color_pairs[pair * 2];
+   return OK;
+}
+
+
+int init_color(short color, short r, short g, short b)
+{
+   if ((color < 0) || (color >= COLORS))
+      return ERR;
+   color_pots[color].r = (r * 255) / 1000;
+   color_pots[color].g = (g * 255) / 1000;
+   color_pots[color].b = (b * 255) / 1000;
+   backing_drop_all();
+   if ((SP != NULL) && (SP->record != NULL))
+      record_color( color );
+   sink_palette();
+   globals_changed();
+   return OK;
+}
+
+int color_content(short color, short *r, short *g, short *b)
+{
+   if ((color < 0) || (color >= COLORS))
+      return ERR;
+   *r = ((color_pots[color].r * 1000) / 255);
+   *g = ((color_pots[color].g * 1000) / 255);
+   *b = ((color_pots[color].b * 1000) / 255);
+   return OK;
+}
+
+/*
+       These routines manipulate the current attributes of the named
+       window.  The current attributes of a window apply to all
+       characters that are written into the window with waddch,
+       waddstr and wprintw.  Attributes are a property of the
+       character, and move with the character through any scrolling
+       and insert/delete line/character operations.  To the extent
+       possible, they are displayed as appropriate modifi- cations to
+       the graphic rendition of characters put on the screen.
+
+       The routine attrset sets the current attributes of the given
+       window to attrs.  The routine attroff turns off the named
+       attributes without turning any other attributes on or off.  The
+       routine attron turns on the named attributes without affecting
+       any others.  The routine standout is the same as
+       attron(A_STANDOUT).  The routine standend is the same as
+       attrset(A_NORMAL) or attrset(0), that is, it turns off all
+       attributes.
+
+       The attrset and related routines do not affect the attributes
+       used when erasing portions of the window.  See curs_bkgd(3X)
+       for func- tions which modify the attributes used for erasing
+       and clearing.
+
+       The routine color_set sets the current color of the given
+       window to the foreground/background combination described by
+       the color_pair_number. The parameter opts is reserved for
+       future use, applications must supply a null pointer.
+
+*/
+int wattrset(WINDOW *win, int attrs)
+{
+   if (attrs < 0)
+      return ERR;
+   win->attributes = attrs;
+   return OK;
+}
+
+int attrset(int attrs)
 {
-   va_list params;
-   int result;
+   return wattrset(stdscr, attrs);
+}
 
-   if (wmove(stdscr, y, x) != OK)
+int wattroff(WINDOW *win, int attrs)
+{
+   if (attrs < 0)
       return ERR;
-   va_start(params, fmt);
-   result = vw_printw(stdscr, fmt, params);
-   va_end(params);
-   return result;
+   win->attributes = win->attributes & ~(attrs & 0xFFFF0000UL);
+   return OK;	
+}
+
+int attroff(int attrs)
+{
+   return wattron(stdscr, attrs);
+}
+
+int wattron(WINDOW *win, int attrs)
+{
+   if (attrs < 0)
+      return ERR;
+   win->attributes = win->attributes | (attrs & 0xFFFF0000UL);
+   return OK;	
+}
 
+int attron(int attrs)
+{
+   return wattron(stdscr, attrs);
 }
 
 /*
-       The start_color routine requires no arguments.  It must be
-       called if the programmer wants to use colors, and before any
-       other color manipulation routine is called.  It is good
-       practice to call this routine right after initscr.  start_color
-       initializes eight basic colors (black, red, green, yellow,
-       blue, magenta, cyan, and white), and two global variables,
-       COLORS and COLOR_PAIRS (respectively defining the maximum
-       number of colors and color-pairs the terminal can support).  It
-       also restores the colors on the terminal to the values they had
-       when the terminal was just turned on.
+  The chgat routines set the attributes of n characters from the
+  cursor, or of the rest of the line if n is -1, to attr and colour
+  pair color, leaving the characters and the cursor where they are.
+  opts is reserved and should be NULL.
+*/
+int wchgat(WINDOW *win, int n, attr_t attr, short color, const void *opts)
+{
+   attr_t attrs = (attr & A_ATTRIBUTES) | COLOR_PAIR( color );
+   int x, end;
 
-       The init_pair routine changes the definition of a color-pair.
-       It takes three arguments: the number of the color-pair to be
-       changed, the foreground color number, and the background color
-       number.  For portable applications:
+   if (!row_expand( win, win->cy ))
+      return ERR;
+   end = ((n < 0) || (n > win->width - win->cx)) ? win->width : win->cx + n;
+   for (x = win->cx; x < end; x++)
+      win->alines[ win->cy ][ x ] = attrs;
+   mark_blink( win, win->cy, attrs );
+   touch_span( win, win->cy, win->cx, end - 1 );
+   return OK;
+}
 
-       - The value of the first argument must be between 1 and
-            COLOR_PAIRS-1.
+int chgat(int n, attr_t attr, short color, const void *opts)
+{
+   return wchgat( stdscr, n, attr, color, opts );
+}
 
-       - The value of the second and third arguments must be between 0
-            and COLORS (the 0 color pair is wired to white on black
-            and cannot be changed).
+int mvwchgat(WINDOW *win, int y, int x, int n, attr_t attr, short color, const void *opts)
+{
+   if (wmove( win, y, x ) != OK)
+      return ERR;
+   return wchgat( win, n, attr, color, opts );
+}
 
-       If the color-pair was previously initialized, the screen is
-       refreshed and all occurrences of that color-pair are changed to
-       the new definition.
+int mvchgat(int y, int x, int n, attr_t attr, short color, const void *opts)
+{
+   return mvwchgat( stdscr, y, x, n, attr, color, opts );
+}
 
-       As an extension, ncurses allows you to set color pair 0 via the
-       assume_default_colors routine, or to specify the use of default
-       colors (color number -1) if you first invoke the
-       use_default_colors routine.
+int wstandend(WINDOW *win)
+{
+   return wattroff(win, A_STANDOUT);
+}
 
-       The init_color routine changes the definition of a color.  It
-       takes four arguments: the number of the color to be changed
-       followed by three RGB values (for the amounts of red, green,
-       and blue components).  The value of the first argument must be
-       between 0 and COLORS.  (See the section Colors for the default
-       color index.)  Each of the last three arguments must be a value
-       between 0 and 1000.  When init_color is used, all occurrences
-       of that color on the screen immediately change to the new
-       definition.
+int standend(void)
+{
+   return wstandend(stdscr);
+}
 
-       The has_colors routine requires no arguments.  It returns TRUE
-       if the terminal can manipulate colors; otherwise, it returns
-       FALSE.  This routine facilitates writing terminal-independent
-       programs.  For example, a programmer can use it to decide
-       whether to use color or some other video attribute.
+int wstandout(WINDOW *win)
+{
+   return wattron(win, A_STANDOUT);
+}
 
-       The can_change_color routine requires no arguments.  It returns
-       TRUE if the terminal supports colors and can change their
-       definitions; other, it returns FALSE.  This routine facilitates
-       writing terminal-independent programs.
+int standout(void)
+{
+   return wstandout(stdscr);
+}
 
-       The color_content routine gives programmers a way to find the
-       intensity of the red, green, and blue (RGB) components in a
-       color.  It requires four arguments: the color number, and three
-       addresses of shorts for storing the information about the
-       amounts of red, green, and blue components in the given color.
-       The value of the first argument must be between 0 and COLORS.
-       The values that are stored at the addresses pointed to by the
-       last three arguments are between 0 (no component) and 1000
-       (maximum amount of component).
+int wcolor_set(WINDOW *win, short color_pair_number, void *opts)
+{
+   win->attributes = (win->attributes & 0xFFFF00FFUL) | COLOR_PAIR(color_pair_number);
+   return color_pair_number;
+}
 
-       The pair_content routine allows programmers to find out what
-       colors a given color-pair consists of.  It requires three
-       arguments: the color-pair number, and two addresses of shorts
-       for storing the foreground and the background color numbers.
-       The value of the first argument must be between 1 and
-       COLOR_PAIRS-1.  The values that are stored at the addresses
-       pointed to by the second and third argu- ments are between 0
-       and COLORS.
+int color_set(short color_pair_number, void *opts)
+{
+   wcolor_set(stdscr, color_pair_number, NULL);
+   return color_pair_number;
+}
+
+/**
+ * misc 
+ */
+int touchwin(WINDOW *win)
+{
+   return touchline(win, 0, win->height);
+}
+
+int touchline(WINDOW *win, int start, int count)
+{
+   int row;
+
+   if ((start < 0) || (start > win->height) || (count < 0))
+      return ERR;
+   for (row = start; (row < start + count) && (row < win->height); row++) {
+      win->firstch[row] = 0;
+      win->lastch[row] = win->width - 1;
+   }
+   return OK;
+}
+
+int echo(void)
+{
+   echo_on = TRUE;
+   globals_changed();
+   return OK;
+}
+
+
+int noecho(void)
+{
+   echo_on = FALSE;
+   globals_changed();
+   return OK;
+}
+
+int clearok(WINDOW *win, bool bf)
+{
+   return OK;
+}
 
+/*
+  Normally, the cursor is left at the window's cursor position after
+  a refresh.  leaveok(win, TRUE) leaves it wherever it was instead,
+  which suits windows that do not use the cursor.
 */
+int leaveok(WINDOW *win, bool bf)
+{
+   win->leaveok = bf;
+   return OK;
+}
 
-int start_color(void)
+/*
+  The curs_set routine sets the cursor state to invisible, normal, or
+  very visible for visibility equal to 0, 1, or 2 respectively, and
+  returns the previous state.  The change is drawn at once, touching
+  only the cursor's cell.
+*/
+int curs_set(int visibility)
 {
-   color_pairs[0] = 0;  /* black */
-   color_pairs[1] = 7;  /* white */
-   color_pairs[2] = 0;  /* black */
-   color_pairs[3] = 7;  /* white */
+   SDL_Rect rects[ 2 ];
+   int nrects;
+   int previous;
+
+   if ((SP == NULL) || (visibility < 0) || (visibility > 2))
+      return ERR;
+   previous = SP->cursor_visibility;
+   SP->cursor_visibility = visibility;
+   if (visibility == previous)
+      return previous;
+
+   /* a terminal's cursor is set at the end of each frame */
+   if (SP->tty != NULL) {
+      sink_frame_end();
+      return previous;
+   }
+   if (SDL_MUSTLOCK( screen ))
+      if (SDL_LockSurface( screen ) < 0)
+	 return previous;
+   nrects = erase_cursor( rects );
+   nrects += draw_cursor( rects + nrects );
+   if (SDL_MUSTLOCK( screen ))
+      SDL_UnlockSurface( screen );
+   present_rects( nrects, rects );
+   return previous;
+}
+
+/* blank every cell of win */
+static void blank_cells(WINDOW *win)
+{
+   if (win->runs != NULL) {
+      free_rows( win );
+      return;
+   }
+   wmemset( win->text, ' ', win->width * win->height );
+   memset( win->attrib, 0, win->width * win->height * sizeof(attr_t) );
+}
+
+int werase(WINDOW *win)
+{
+   win->cx = 0;
+   win->cy = 0;
+   blank_cells( win );
+   clear_blink_rows( win );
+   touch_rows( win, 0, win->height );
+   return OK;
+}
+
+int erase(void)
+{
+   return werase(stdscr);
+}
+
+int wclear(WINDOW *win)
+{
+   win->cx = 0;
+   win->cy = 0;
+   blank_cells( win );
+   clear_blink_rows( win );
+   touch_rows( win, 0, win->height );
+   return OK;
+}
+
+int clear()
+{
+   return wclear(stdscr);
+}
+
+int scrollok(WINDOW *win, bool bf)
+{
+   /* stub that does nothing */
+   if (bf == FALSE)
+      return OK;
+   else
+      return ERR; /* not yet implemented */
+}
+
+/*
+ * recording and replay
+ */
+
+/*
+  recordframes starts writing what the current screen draws to the
+  file path: the cells each refresh draws, colour and pair changes,
+  resizes and the keys read, all timed.  Every window is touched, so
+  the first refreshes record a whole picture.  recordframes(NULL)
+  stops, returning ERR if the stream could not all be written.
+*/
+int recordframes(const char *path)
+{
+   WINDOW *win;
+   FILE *f;
+   int i;
+   int result = OK;
+
+   if (SP == NULL)
+      return ERR;
+   if (SP->record != NULL) {
+      if (ferror( SP->record ))
+	 result = ERR;
+      if (fclose( SP->record ) != 0)
+	 result = ERR;
+      SP->record = NULL;
+   }
+   if (path == NULL)
+      return result;
 
+   f = fopen( path, "wb" );
+   if (f == NULL)
+      return ERR;
+   SP->record = f;
+   SP->record_start = SDL_GetTicks();
+   SP->record_frame = FALSE;
+   fwrite( RECORD_MAGIC, 1, sizeof(RECORD_MAGIC) - 1, f );
+   putc( RECORD_VERSION, f );
+   put_varint( f, LINES );
+   put_varint( f, COLS );
+   for (i = 0; i < COLORS; i++)
+      record_color( i );
+   for (i = 0; i < COLOR_PAIRS; i++)
+      record_pair( i );
+   for (win = SP->windows; win != NULL; win = win->next)
+      touchwin( win );
    return OK;
 }
 
-bool has_colors(void)
+/* read the spans of a frame record into win, FALSE if the stream
+ * ends or is damaged */
+static bool replay_spans(FILE *f, WINDOW *win)
 {
-   return TRUE;
+   unsigned long row, col, n, len, wc, attrs, x, i, end;
+
+   for (;;) {
+      if (!get_varint( f, &row ))
+	 return FALSE;
+      if (row-- == 0)
+	 return TRUE;
+      if (!get_varint( f, &col ) || !get_varint( f, &n ))
+	 return FALSE;
+      end = col + n;
+      for (x = col; x < end; x += len) {
+	 if (!get_varint( f, &len ) || !get_varint( f, &wc ) || !get_varint( f, &attrs ) ||
+	     (len == 0))
+	    return FALSE;
+	 /* what is off the screen is read and dropped */
+	 if ((row >= (unsigned long) win->height) || !row_expand( win, row ))
+	    continue;
+	 for (i = x; (i < x + len) && (i < (unsigned long) win->width); i++) {
+	    win->lines[row][i] = stored_char( (i > 0) ? win->lines[row][i - 1] : ' ',
+					      (wchar_t) wc );
+	    win->alines[row][i] = (attr_t) attrs;
+	 }
+	 mark_blink( win, row, (attr_t) attrs );
+      }
+      if ((row < (unsigned long) win->height) && (col < (unsigned long) win->width))
+	 touch_span( win, row, col, (end < (unsigned long) win->width) ? end - 1 : win->width - 1 );
+   }
 }
 
-bool can_change_color(void)
+/* wait until ms after start, when replaying at the recorded speed */
+static void replay_wait(Uint32 start, unsigned long ms)
 {
-   return TRUE;
+   Sint32 left = (Sint32) (start + ms - SDL_GetTicks());
+
+   if (left > 0)
+      SDL_Delay( left );
 }
 
-int init_pair(short pair, short f, short b)
+/* whether a recorded size is one a screen can have */
+static bool replay_size_ok(unsigned long lines, unsigned long cols)
 {
-/*   fprintf(stderr, "Set pair %d to %x %x \n\r", pair, f, b); */
-   if ((pair <= 0) || (pair >= COLOR_PAIRS))
-      return ERR;
-   color_pairs[pair * 2] = b;
-   color_pairs[pair * 2 + 1] = f;
-   return OK;
+   return (lines >= 1) && (lines <= RESIZE_MAX) && (cols >= 1) && (cols <= RESIZE_MAX);
 }
 
-int pair_content(short pair, short *f, short *b)
+/* a colour or pair the replay set has changed: tell whoever needs to
+ * know, as init_color and init_pair do */
+static void replay_palette(int color, int pair)
 {
-   if ((pair <= 0) || (pair >= COLOR_PAIRS))
-      return ERR;
-   *f = color_pairs[pair * 2 + 1];
-   *b = color_pairs[pair * 2];
-   return OK;
+   if (SP->record != NULL) {
+      if (color >= 0)
+	 record_color( color );
+      if (pair >= 0)
+	 record_pair( pair );
+   }
+   backing_drop_all();
+   sink_palette();
 }
 
-
-int init_color(short color, short r, short g, short b)
+/* put back the colours and pairs the screen had before the replay */
+static void replay_unpalette(const SDL_Color *pots, const short *pairs)
 {
-   if ((color < 0) || (color >= COLORS))
-      return ERR;
-   color_pots[color].r = (r * 255) / 1000;
-   color_pots[color].g = (g * 255) / 1000;
-   color_pots[color].b = (b * 255) / 1000;
-   return OK;
+   bool changed = FALSE;
+   int i;
+
+   for (i = 0; i < COLORS; i++)
+      if (memcmp( &color_pots[i], &pots[i], sizeof(SDL_Color) ) != 0) {
+	 color_pots[i] = pots[i];
+	 if (SP->record != NULL)
+	    record_color( i );
+	 changed = TRUE;
+      }
+   for (i = 0; i < COLOR_PAIRS; i++)
+      if ((color_pairs[i * 2] != pairs[i * 2]) || (color_pairs[i * 2 + 1] != pairs[i * 2 + 1])) {
+	 color_pairs[i * 2] = pairs[i * 2];
+	 color_pairs[i * 2 + 1] = pairs[i * 2 + 1];
+	 if (SP->record != NULL)
+	    record_pair( i );
+	 changed = TRUE;
+      }
+   if (changed) {
+      backing_drop_all();
+      sink_palette();
+   }
 }
 
-int color_content(short color, short *r, short *g, short *b)
+/*
+  replayframes plays a stream made by recordframes on the current
+  screen, at the speed it was recorded, or as fast as it can be drawn
+  if realtime is FALSE.  The screen may be one without the display,
+  for timing the renderer alone.  It is resized to the recorded size
+  and drawn through a window of its own, which is deleted at the end;
+  the recorded colours and pairs are used while it plays and the
+  screen's own are put back after.  Recorded keys only set the pace.  Returns the number of frames
+  drawn, or ERR if the file is not a stream or is damaged; one that
+  was cut short is played as far as it goes.
+*/
+long replayframes(const char *path, bool realtime)
 {
-   if ((color < 0) || (color >= COLORS))
+   char magic[ sizeof(RECORD_MAGIC) - 1 ];
+   SDL_Color pots[ COLORS ];
+   short pairs[ COLOR_PAIRS * 2 ];
+   unsigned long a, b, c, d;
+   WINDOW *win = NULL;
+   FILE *f;
+   Uint32 start;
+   long frames = 0;
+   bool ok = TRUE;
+   int tag;
+
+   if (SP == NULL)
       return ERR;
-   *r = ((color_pots[color].r * 1000) / 255);
-   *g = ((color_pots[color].g * 1000) / 255);
-   *b = ((color_pots[color].b * 1000) / 255);
-   return OK;
+   f = fopen( path, "rb" );
+   if (f == NULL)
+      return ERR;
+   if ((fread( magic, 1, sizeof(magic), f ) != sizeof(magic)) ||
+       (memcmp( magic, RECORD_MAGIC, sizeof(magic) ) != 0) ||
+       (getc( f ) != RECORD_VERSION) || !get_varint( f, &a ) || !get_varint( f, &b ) ||
+       !replay_size_ok( a, b )) {
+      fclose( f );
+      return ERR;
+   }
+   resizeterm( (int) a, (int) b );
+   win = newwin( LINES, COLS, 0, 0 );
+   if (win == NULL) {
+      fclose( f );
+      return ERR;
+   }
+   memcpy( pots, color_pots, sizeof(pots) );
+   memcpy( pairs, color_pairs, sizeof(pairs) );
+
+   start = SDL_GetTicks();
+   while (ok && ((tag = getc( f )) != EOF)) {
+      switch (tag) {
+	 case 'F':
+	    if (!get_varint( f, &a ))
+	       break;
+	    if (realtime)
+	       replay_wait( start, a );
+	    if (!replay_spans( f, win ))
+	       break;
+	    wrefresh( win );
+	    frames++;
+	    continue;
+	 case 'C':
+	    if (!get_varint( f, &a ) || !get_varint( f, &b ) || !get_varint( f, &c ) ||
+		!get_varint( f, &d ))
+	       break;
+	    if ((a >= COLORS) || (b > 255) || (c > 255) || (d > 255)) {
+	       frames = ERR;
+	       break;
+	    }
+	    color_pots[a].r = (Uint8) b;
+	    color_pots[a].g = (Uint8) c;
+	    color_pots[a].b = (Uint8) d;
+	    replay_palette( (int) a, -1 );
+	    continue;
+	 case 'P':
+	    if (!get_varint( f, &a ) || !get_varint( f, &b ) || !get_varint( f, &c ))
+	       break;
+	    if ((a >= COLOR_PAIRS) || (b >= COLORS) || (c >= COLORS)) {
+	       frames = ERR;
+	       break;
+	    }
+	    color_pairs[a * 2 + 1] = (short) b;
+	    color_pairs[a * 2] = (short) c;
+	    replay_palette( -1, (int) a );
+	    continue;
+	 case 'S':
+	    if (!get_varint( f, &a ) || !get_varint( f, &b ))
+	       break;
+	    if (!replay_size_ok( a, b )) {
+	       frames = ERR;
+	       break;
+	    }
+	    if (resizeterm( (int) a, (int) b ) == OK)
+	       wresize( win, LINES, COLS );
+	    continue;
+	 case 'K':
+	    if (!get_varint( f, &a ) || !get_varint( f, &b ) || !get_varint( f, &c ) ||
+		!get_varint( f, &d ))
+	       break;
+	    if (realtime)
+	       replay_wait( start, a );
+	    continue;
+	 default:
+	    frames = ERR;
+	    break;
+      }
+      /* a record that could not be read ends the replay */
+      ok = FALSE;
+   }
+
+   replay_unpalette( pots, pairs );
+   globals_changed();
+   delwin( win );
+   fclose( f );
+   return frames;
 }
 
 /*
-       These routines manipulate the current attributes of the named
-       window.  The current attributes of a window apply to all
-       characters that are written into the window with waddch,
-       waddstr and wprintw.  Attributes are a property of the
-       character, and move with the character through any scrolling
-       and insert/delete line/character operations.  To the extent
-       possible, they are displayed as appropriate modifi- cations to
-       the graphic rendition of characters put on the screen.
+ * window dumps
+ */
 
-       The routine attrset sets the current attributes of the given
-       window to attrs.  The routine attroff turns off the named
-       attributes without turning any other attributes on or off.  The
-       routine attron turns on the named attributes without affecting
-       any others.  The routine standout is the same as
-       attron(A_STANDOUT).  The routine standend is the same as
-       attrset(A_NORMAL) or attrset(0), that is, it turns off all
-       attributes.
+/* putwin writes a DUMP_HEADER and then the cells, a DUMP_CELL each,
+ * row by row, in the writer's byte order, which DUMP_ORDER records.
+ * The cells are fixed size and start DUMP_HEADER's size bytes in, so
+ * getwin maps them straight from the file where it can. */
+#define DUMP_MAGIC "SDLcwin"
+#define DUMP_VERSION (1)
+#define DUMP_ORDER (0x01020304UL)
 
-       The attrset and related routines do not affect the attributes
-       used when erasing portions of the window.  See curs_bkgd(3X)
-       for func- tions which modify the attributes used for erasing
-       and clearing.
+#define DUMP_MAX_SIDE (0x7fff)	/* rows or columns a dump may have */
 
-       The routine color_set sets the current color of the given
-       window to the foreground/background combination described by
-       the color_pair_number. The parameter opts is reserved for
-       future use, applications must supply a null pointer.
+#define DUMP_KEYPAD (1)
+#define DUMP_LEAVEOK (2)
+#define DUMP_PACKED (4)
 
-*/
-int wattrset(WINDOW *win, int attrs)
+typedef struct s_DumpHeader
 {
-   if (attrs < 0)
-      return ERR;
-   win->attributes = attrs;
-   return OK;
+      char magic[ 8 ];		/* DUMP_MAGIC */
+      Uint32 version;
+      Uint32 order;		/* DUMP_ORDER */
+      Uint32 size;		/* of the header, which later versions may grow */
+      Uint32 height, width;
+      Sint32 y, x;
+      Sint32 cy, cx;
+      Sint32 delay;
+      Uint32 attributes;
+      Uint32 flags;		/* DUMP_KEYPAD, ... */
+} DUMP_HEADER;
+
+typedef struct s_DumpCell
+{
+      Uint32 wc;
+      Uint32 attr;
+} DUMP_CELL;
+
+/* read and check the header of a dump, leaving f at its cells.  The
+ * cells must start aligned, to be mapped, and where f can seek they
+ * must all be there, so that a damaged dump never sizes a window. */
+static bool read_dump_header(FILE *f, DUMP_HEADER *head)
+{
+   long start, end;
+
+   if ((fread( head, sizeof(DUMP_HEADER), 1, f ) != 1) ||
+       (memcmp( head->magic, DUMP_MAGIC, sizeof(DUMP_MAGIC) ) != 0) ||
+       (head->version != DUMP_VERSION) || (head->order != DUMP_ORDER) ||
+       (head->size < sizeof(DUMP_HEADER)) || (head->size % sizeof(Uint32) != 0) ||
+       (head->height == 0) || (head->width == 0) ||
+       (head->height > DUMP_MAX_SIDE) || (head->width > DUMP_MAX_SIDE))
+      return FALSE;
+   if ((head->size != sizeof(DUMP_HEADER)) &&
+       (fseek( f, head->size - sizeof(DUMP_HEADER), SEEK_CUR ) != 0))
+      return FALSE;
+   start = ftell( f );
+   if ((start < 0) || (fseek( f, 0, SEEK_END ) != 0))
+      return TRUE;		/* a pipe: the reads will tell */
+   end = ftell( f );
+   if (fseek( f, start, SEEK_SET ) != 0)
+      return FALSE;
+   return (end >= start) &&
+      ((Uint64) (end - start) >= (Uint64) head->height * head->width * sizeof(DUMP_CELL));
 }
 
-int attrset(int attrs)
+/* store a row of dumped cells in row y of win, as far as they fit */
+static void load_row(WINDOW *win, int y, const DUMP_CELL *cells, int n)
 {
-   return wattrset(stdscr, attrs);
+   int x;
+
+   if ((y >= win->height) || !row_expand( win, y ))
+      return;
+   if (n > win->width)
+      n = win->width;
+   for (x = 0; x < n; x++) {
+      win->lines[y][x] = stored_char( (x > 0) ? win->lines[y][x - 1] : ' ',
+				      (wchar_t) cells[x].wc );
+      win->alines[y][x] = (attr_t) cells[x].attr;
+      mark_blink( win, y, win->alines[y][x] );
+   }
+   /* a double-width character cut in half by the edge goes */
+   if ((n < (int) win->width) && (n > 0) && (char_cells( win->lines[y][n - 1] ) == 2))
+      win->lines[y][n - 1] = ' ';
 }
 
-int wattroff(WINDOW *win, int attrs)
+/* read the cells that follow head into win, mapping them from the
+ * file if it can be mapped, and leave f after them */
+static bool read_dump_cells(FILE *f, const DUMP_HEADER *head, WINDOW *win)
 {
-   if (attrs < 0)
+   size_t row_bytes = head->width * sizeof(DUMP_CELL);
+   long start = ftell( f );
+   DUMP_CELL *row;
+   Uint32 y;
+#ifdef SDL_CURSES_POSIX
+   struct stat st;
+   Uint8 *map;
+   size_t end;
+
+   /* a file cut short is read, to fail, as mapping past its end would
+    * fault, and so are cells that would not be aligned in memory */
+   end = start + head->height * row_bytes;
+   if ((start >= 0) && (start % sizeof(Uint32) == 0) && (fstat( fileno( f ), &st ) == 0) && ((size_t) st.st_size >= end)) {
+      map = mmap( NULL, end, PROT_READ, MAP_PRIVATE, fileno( f ), 0 );
+      if (map != MAP_FAILED) {
+	 for (y = 0; y < head->height; y++)
+	    load_row( win, y, (const DUMP_CELL *) (map + start + y * row_bytes), head->width );
+	 munmap( map, end );
+	 return fseek( f, (long) end, SEEK_SET ) == 0;
+      }
+   }
+#endif
+
+   row = malloc( row_bytes );
+   if (row == NULL)
+      return FALSE;
+   for (y = 0; y < head->height; y++) {
+      if (fread( row, row_bytes, 1, f ) != 1) {
+	 free( row );
+	 return FALSE;
+      }
+      load_row( win, y, row, head->width );
+   }
+   free( row );
+   return TRUE;
+}
+
+/*
+  putwin writes everything about win to filep, from which getwin
+  makes a window just like it; scr_dump writes curscr to a file that
+  scr_restore puts back into curscr, to be shown at its next refresh.
+  The dumps are in a binary format of this library's own.
+*/
+int putwin(WINDOW *win, FILE *filep)
+{
+   DUMP_HEADER head;
+   DUMP_CELL *row;
+   int y, x;
+   bool ok = TRUE;
+
+   if ((win == NULL) || (filep == NULL))
       return ERR;
-   win->attributes = win->attributes & ~(attrs & 0xFFFF0000UL);
-   return OK;	
+   memset( &head, 0, sizeof(head) );
+   memcpy( head.magic, DUMP_MAGIC, sizeof(DUMP_MAGIC) );
+   head.version = DUMP_VERSION;
+   head.order = DUMP_ORDER;
+   head.size = sizeof(DUMP_HEADER);
+   head.height = win->height;
+   head.width = win->width;
+   head.y = win->y;
+   head.x = win->x;
+   head.cy = win->cy;
+   head.cx = win->cx;
+   head.delay = win->delay;
+   head.attributes = win->attributes;
+   head.flags = (win->keypad_on ? DUMP_KEYPAD : 0) | (win->leaveok ? DUMP_LEAVEOK : 0) |
+      ((win->runs != NULL) ? DUMP_PACKED : 0);
+
+   row = malloc( win->width * sizeof(DUMP_CELL) );
+   if (row == NULL)
+      return ERR;
+   ok = fwrite( &head, sizeof(head), 1, filep ) == 1;
+   for (y = 0; ok && (y < win->height); y++) {
+      for (x = 0; x < win->width; x++) {
+	 row[x].wc = cell_char( win, y, x );
+	 row[x].attr = cell_attrib( win, y, x );
+      }
+      ok = fwrite( row, win->width * sizeof(DUMP_CELL), 1, filep ) == 1;
+   }
+   free( row );
+   return ok ? OK : ERR;
 }
 
-int attroff(int attrs)
+WINDOW *getwin(FILE *filep)
 {
-   return wattron(stdscr, attrs);
+   DUMP_HEADER head;
+   WINDOW *win;
+
+   if ((SP == NULL) || (filep == NULL) || !read_dump_header( filep, &head ))
+      return NULL;
+   win = newwin( head.height, head.width, head.y, head.x );
+   if (win == NULL)
+      return NULL;
+   if (!read_dump_cells( filep, &head, win )) {
+      delwin( win );
+      return NULL;
+   }
+   win->cy = ((head.cy >= 0) && (head.cy < win->height)) ? head.cy : 0;
+   win->cx = ((head.cx >= 0) && (head.cx < win->width)) ? head.cx : 0;
+   win->delay = head.delay;
+   win->attributes = head.attributes;
+   win->keypad_on = (head.flags & DUMP_KEYPAD) != 0;
+   win->leaveok = (head.flags & DUMP_LEAVEOK) != 0;
+   if (head.flags & DUMP_PACKED)
+      compressrows( win, TRUE );
+   else if (win->runs != NULL)
+      compressrows( win, FALSE );
+   return win;
 }
 
-int wattron(WINDOW *win, int attrs)
+int scr_dump(const char *filename)
 {
-   if (attrs < 0)
+   FILE *f;
+   int result;
+
+   if ((curscr == NULL) || (filename == NULL))
       return ERR;
-   win->attributes = win->attributes | (attrs & 0xFFFF0000UL);
-   return OK;	
+   f = fopen( filename, "wb" );
+   if (f == NULL)
+      return ERR;
+   result = putwin( curscr, f );
+   if (fclose( f ) != 0)
+      result = ERR;
+   return result;
 }
 
-int attron(int attrs)
+int scr_restore(const char *filename)
 {
-   return wattron(stdscr, attrs);
+   DUMP_HEADER head;
+   FILE *f;
+   bool ok;
+
+   if ((curscr == NULL) || (filename == NULL))
+      return ERR;
+   f = fopen( filename, "rb" );
+   if (f == NULL)
+      return ERR;
+   blank_cells( curscr );
+   clear_blink_rows( curscr );
+   ok = read_dump_header( f, &head ) && read_dump_cells( f, &head, curscr );
+   fclose( f );
+   touchwin( curscr );
+   return ok ? OK : ERR;
 }
 
-int wstandend(WINDOW *win)
+/*
+ * PNG snapshots
+ */
+
+/* scr_png copies the screen's pixels, which is all the calling thread
+ * does; a thread of the snapshot's own encodes them as an RGB PNG.
+ * The encoder is this library's own: each row is filtered with PNG's
+ * Up filter, which turns rows like the one above into zeros, and the
+ * result is deflated in one block with the fixed Huffman codes and
+ * matches found through a hash of the next three bytes.  Screens of
+ * text repeat a lot, so that is most of what a better deflate would
+ * gain.  One snapshot is written at a time: the next waits for the
+ * last. */
+#define PNG_HASH_BITS (15)
+#define PNG_WINDOW (32768)
+#define PNG_MAX_MATCH (258)
+
+typedef struct s_PngJob
 {
-   return wattroff(win, A_STANDOUT);
+      SDL_Surface *copy;	/* of the screen */
+      char *path;
+      int result;		/* OK once written */
+} PNG_JOB;
+
+/* a growing buffer, into which deflate writes bits from the low end
+ * of each byte up */
+typedef struct s_PngBuffer
+{
+      Uint8 *data;
+      size_t size, used;
+      Uint32 bits;		/* not yet a whole byte */
+      int nbits;
+      bool failed;		/* memory ran out */
+} PNG_BUFFER;
+
+static void png_byte(PNG_BUFFER *buf, int byte)
+{
+   Uint8 *data;
+
+   if (buf->used == buf->size) {
+      data = buf->failed ? NULL : realloc( buf->data, buf->size * 2 + 4096 );
+      if (data == NULL) {
+	 buf->failed = TRUE;
+	 return;
+      }
+      buf->data = data;
+      buf->size = buf->size * 2 + 4096;
+   }
+   buf->data[ buf->used++ ] = (Uint8) byte;
 }
 
-int standend(void)
+static void png_u32(PNG_BUFFER *buf, Uint32 v)
 {
-   return wstandend(stdscr);
+   png_byte( buf, v >> 24 );
+   png_byte( buf, (v >> 16) & 0xff );
+   png_byte( buf, (v >> 8) & 0xff );
+   png_byte( buf, v & 0xff );
 }
 
-int wstandout(WINDOW *win)
+/* n bits of v, least significant first, as deflate's extra bits are */
+static void png_bits(PNG_BUFFER *buf, Uint32 v, int n)
 {
-   return wattron(win, A_STANDOUT);
+   buf->bits |= v << buf->nbits;
+   buf->nbits += n;
+   while (buf->nbits >= 8) {
+      png_byte( buf, buf->bits & 0xff );
+      buf->bits >>= 8;
+      buf->nbits -= 8;
+   }
 }
 
-int standout(void)
+/* an n bit Huffman code, which goes most significant bit first */
+static void png_code(PNG_BUFFER *buf, Uint32 code, int n)
 {
-   return wstandout(stdscr);
+   Uint32 reversed = 0;
+   int i;
+
+   for (i = 0; i < n; i++)
+      reversed |= ((code >> i) & 1) << (n - 1 - i);
+   png_bits( buf, reversed, n );
 }
 
-int wcolor_set(WINDOW *win, short color_pair_number, void *opts)
+/* a literal byte or length symbol in deflate's fixed code */
+static void png_symbol(PNG_BUFFER *buf, int sym)
 {
-   win->attributes = (win->attributes & 0xFFFF00FFUL) | COLOR_PAIR(color_pair_number);
-   return color_pair_number;
+   if (sym < 144)
+      png_code( buf, 0x30 + sym, 8 );
+   else if (sym < 256)
+      png_code( buf, 0x190 + sym - 144, 9 );
+   else if (sym < 280)
+      png_code( buf, sym - 256, 7 );
+   else
+      png_code( buf, 0xc0 + sym - 280, 8 );
 }
 
-int color_set(short color_pair_number, void *opts)
+static void png_match(PNG_BUFFER *buf, int len, int dist)
 {
-   wcolor_set(stdscr, color_pair_number, NULL);
-   return color_pair_number;
+   static const Uint16 len_base[ 29 ] = {
+      3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+   static const Uint8 len_extra[ 29 ] = {
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+   static const Uint16 dist_base[ 30 ] = {
+      1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+      513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+   static const Uint8 dist_extra[ 30 ] = {
+      0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+      8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+   int i;
+
+   for (i = 28; len_base[i] > len; i--)
+      ;
+   png_symbol( buf, 257 + i );
+   png_bits( buf, len - len_base[i], len_extra[i] );
+   for (i = 29; dist_base[i] > dist; i--)
+      ;
+   png_code( buf, i, 5 );
+   png_bits( buf, dist - dist_base[i], dist_extra[i] );
 }
 
-/**
- * misc 
- */
-int touchwin(WINDOW *win)
+static unsigned int png_hash(const Uint8 *p)
 {
-   return OK;
+   return ((p[0] << 16 | p[1] << 8 | p[2]) * 2654435761U) >> (32 - PNG_HASH_BITS);
 }
 
-int echo(void)
+/* deflate n bytes of data into buf as one final fixed-code block */
+static bool png_deflate(PNG_BUFFER *buf, const Uint8 *data, size_t n)
 {
-   echo_on = TRUE;
-   return OK;
+   long *head = malloc( ((size_t) 1 << PNG_HASH_BITS) * sizeof(long) );
+   size_t pos = 0;
+   size_t i, len, max;
+   long cand;
+
+   if (head == NULL)
+      return FALSE;
+   for (i = 0; i < ((size_t) 1 << PNG_HASH_BITS); i++)
+      head[i] = -1;
+
+   png_bits( buf, 1, 1 );	/* the last block */
+   png_bits( buf, 1, 2 );	/* with the fixed codes */
+   while (pos < n) {
+      len = 0;
+      if (pos + 3 <= n) {
+	 i = png_hash( data + pos );
+	 cand = head[i];
+	 head[i] = (long) pos;
+	 if ((cand >= 0) && (pos - cand <= PNG_WINDOW)) {
+	    max = (n - pos < PNG_MAX_MATCH) ? n - pos : PNG_MAX_MATCH;
+	    while ((len < max) && (data[ cand + len ] == data[ pos + len ]))
+	       len++;
+	 }
+      }
+      if (len < 3) {
+	 png_symbol( buf, data[ pos++ ] );
+	 continue;
+      }
+      png_match( buf, (int) len, (int) (pos - cand) );
+      /* the bytes matched are hashed too, so later matches may start in them */
+      for (i = pos + 1; (i < pos + len) && (i + 3 <= n); i++)
+	 head[ png_hash( data + i ) ] = (long) i;
+      pos += len;
+   }
+   png_symbol( buf, 256 );
+   png_bits( buf, 0, 7 );	/* out to a whole byte */
+   free( head );
+   return !buf->failed;
 }
 
+/* the CRC of a chunk, as PNG defines it */
+static Uint32 png_crc(const Uint32 *table, const Uint8 *p, size_t n)
+{
+   Uint32 crc = 0xffffffffUL;
 
-int noecho(void)
+   while (n-- > 0)
+      crc = table[ (crc ^ *p++) & 0xff ] ^ (crc >> 8);
+   return crc ^ 0xffffffffUL;
+}
+
+/* finish the chunk whose length and type start at buf's byte start */
+static void png_end_chunk(PNG_BUFFER *buf, const Uint32 *table, size_t start)
 {
-   echo_on = FALSE;
-   return OK;
+   size_t len = buf->used - start - 8;
+
+   if (buf->failed)
+      return;
+   buf->data[ start ] = (Uint8) (len >> 24);
+   buf->data[ start + 1 ] = (Uint8) (len >> 16);
+   buf->data[ start + 2 ] = (Uint8) (len >> 8);
+   buf->data[ start + 3 ] = (Uint8) len;
+   png_u32( buf, png_crc( table, buf->data + start + 4, len + 4 ) );
 }
 
-int clearok(WINDOW *win, bool bf)
+static void png_begin_chunk(PNG_BUFFER *buf, const char *type)
 {
-   return OK;
+   png_u32( buf, 0 );		/* the length, filled in at the end */
+   png_byte( buf, type[0] );
+   png_byte( buf, type[1] );
+   png_byte( buf, type[2] );
+   png_byte( buf, type[3] );
 }
 
-int werase(WINDOW *win)
+/* the bytes of the image: each row an Up filter byte and the row's
+ * RGB less the one above */
+static Uint8 *png_rows(SDL_Surface *surface, size_t *n)
 {
-   win->cx = 0;
-   win->cy = 0;
-   memset( win->text, 32, win->width * win->height * sizeof(char) );
-   memset( win->attrib, 0, win->width * win->height * sizeof(attr_t) );
-   return OK;
+   int bpp = surface->format->BytesPerPixel;
+   size_t stride = 1 + surface->w * 3;
+   Uint8 *rows = malloc( stride * surface->h );
+   Uint8 *row, *above;
+   const Uint8 *p;
+   int x, y, i;
+
+   if (rows == NULL)
+      return NULL;
+   for (y = 0; y < surface->h; y++) {
+      row = rows + y * stride;
+      row[0] = 2;
+      p = (const Uint8 *) surface->pixels + y * surface->pitch;
+      for (x = 0; x < surface->w; x++, p += bpp)
+	 SDL_GetRGB( get_pixel( p, bpp ), surface->format,
+		     row + 1 + x * 3, row + 2 + x * 3, row + 3 + x * 3 );
+   }
+   /* from the bottom up, so each row is filtered against the unfiltered one above */
+   for (y = surface->h - 1; y > 0; y--) {
+      row = rows + y * stride;
+      above = row - stride;
+      for (i = 1; i < (int) stride; i++)
+	 row[i] -= above[i];
+   }
+   *n = stride * surface->h;
+   return rows;
 }
 
-int erase(void)
+static int png_worker(void *data)
 {
-   return werase(stdscr);
+   PNG_JOB *job = data;
+   PNG_BUFFER buf;
+   Uint32 table[ 256 ];
+   Uint32 c, a = 1, b = 0;
+   Uint8 *rows;
+   size_t n, i, start;
+   FILE *f;
+   bool written;
+   int k;
+
+   for (i = 0; i < 256; i++) {
+      c = (Uint32) i;
+      for (k = 0; k < 8; k++)
+	 c = (c & 1) ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+      table[i] = c;
+   }
+
+   rows = png_rows( job->copy, &n );
+   if (rows == NULL)
+      return 0;
+   memset( &buf, 0, sizeof(buf) );
+   for (i = 0; i < 8; i++)
+      png_byte( &buf, "\211PNG\r\n\032\n"[i] );
+
+   start = buf.used;
+   png_begin_chunk( &buf, "IHDR" );
+   png_u32( &buf, job->copy->w );
+   png_u32( &buf, job->copy->h );
+   png_byte( &buf, 8 );		/* bits per sample */
+   png_byte( &buf, 2 );		/* RGB */
+   png_byte( &buf, 0 );
+   png_byte( &buf, 0 );
+   png_byte( &buf, 0 );
+   png_end_chunk( &buf, table, start );
+
+   start = buf.used;
+   png_begin_chunk( &buf, "IDAT" );
+   png_byte( &buf, 0x78 );	/* zlib's header: deflate, 32K window */
+   png_byte( &buf, 0x01 );
+   if (!png_deflate( &buf, rows, n ))
+      buf.failed = TRUE;
+   for (i = 0; i < n; i++) {
+      a = (a + rows[i]) % 65521;
+      b = (b + a) % 65521;
+   }
+   png_u32( &buf, (b << 16) | a );
+   png_end_chunk( &buf, table, start );
+
+   start = buf.used;
+   png_begin_chunk( &buf, "IEND" );
+   png_end_chunk( &buf, table, start );
+   free( rows );
+
+   if (!buf.failed) {
+      f = fopen( job->path, "wb" );
+      if (f != NULL) {
+	 written = fwrite( buf.data, 1, buf.used, f ) == buf.used;
+	 if ((fclose( f ) == 0) && written)
+	    job->result = OK;
+      }
+   }
+   free( buf.data );
+   return 0;
 }
 
-int wclear(WINDOW *win)
+/*
+  scr_png writes a PNG of what the current screen shows to filename.
+  Only the copying of the pixels is done before it returns; they are
+  encoded and written by a thread of the snapshot's own.  It returns
+  ERR if the pixels could not be copied; scr_png(NULL) waits for the
+  last snapshot and returns whether it was written.
+*/
+int scr_png(const char *filename)
 {
-   win->cx = 0;
-   win->cy = 0;
-   memset( win->text, 32, win->width * win->height * sizeof(char) );
-   memset( win->attrib, 0, win->width * win->height * sizeof(attr_t) );
+   PNG_JOB *job;
+   int result = OK;
+
+   if (SP == NULL)
+      return ERR;
+
+   /* one at a time */
+   if (SP->png_thread != NULL) {
+      SDL_WaitThread( SP->png_thread, NULL );
+      SP->png_thread = NULL;
+   }
+   if (SP->png_job != NULL) {
+      result = SP->png_job->result;
+      SDL_FreeSurface( SP->png_job->copy );
+      free( SP->png_job );
+      SP->png_job = NULL;
+   }
+   if (filename == NULL)
+      return result;
+   /* a screen on a terminal has no pixels */
+   if (screen == NULL)
+      return ERR;
+
+   job = malloc( sizeof(PNG_JOB) + strlen( filename ) + 1 );
+   if (job == NULL)
+      return ERR;
+   job->copy = like_surface( screen, screen_width, screen_height );
+   if (job->copy == NULL) {
+      free( job );
+      return ERR;
+   }
+   copy_pixels( job->copy, screen, screen_width, screen_height );
+   job->path = (char *) (job + 1);
+   strcpy( job->path, filename );
+   job->result = ERR;
+
+   SP->png_job = job;
+   SP->png_thread = SDL_CreateThread( png_worker, job );
+   if (SP->png_thread == NULL)
+      png_worker( job );
    return OK;
 }
 
-int clear()
+/*
+ * mirroring
+ */
+
+/*
+  shmmirror publishes the current screen's cells in the POSIX shared
+  memory object name, which it makes readable by its owner only, and
+  every window is touched so that the next refreshes fill it in.
+  shmmirror(NULL) stops and removes the object.  Returns ERR where
+  there is no shared memory.
+*/
+int shmmirror(const char *name)
 {
-   return wclear(stdscr);
+#ifdef SDL_CURSES_MIRROR
+   MIRROR *m = (SP != NULL) ? SP->mirror : NULL;
+   WINDOW *win;
+
+   if (SP == NULL)
+      return ERR;
+   if (m != NULL) {
+      munmap( m->head, m->size );
+      close( m->fd );
+      shm_unlink( m->name );
+      free( m );
+      SP->mirror = NULL;
+   }
+   if (name == NULL)
+      return OK;
+
+   m = malloc( sizeof(MIRROR) + strlen( name ) );
+   if (m == NULL)
+      return ERR;
+   strcpy( m->name, name );
+   m->head = NULL;
+   m->size = 0;
+   m->writing = FALSE;
+   m->fd = shm_open( name, O_RDWR | O_CREAT | O_TRUNC, 0600 );
+   if (m->fd < 0) {
+      free( m );
+      return ERR;
+   }
+   if (!mirror_size( m, LINES, COLS )) {
+      if (m->head != NULL)
+	 munmap( m->head, m->size );
+      close( m->fd );
+      shm_unlink( name );
+      free( m );
+      return ERR;
+   }
+   memcpy( m->head->magic, "SDLcshm", 8 );
+   m->head->version = MIRROR_VERSION;
+   m->head->size = sizeof(SCREEN_MIRROR);
+   mirror_end( m );
+
+   SP->mirror = m;
+   for (win = SP->windows; win != NULL; win = win->next)
+      touchwin( win );
+   return OK;
+#else
+   return ERR;
+#endif
 }
 
-int scrollok(WINDOW *win, bool bf)
+/*
+ * streaming
+ */
+
+/*
+  streamcells serves the current screen's cells to viewers connecting
+  to the Unix domain socket at path, which it makes accessible to its
+  owner only, and every window is touched so that the next refreshes
+  fill in its copy of the screen.  streamcells(NULL) stops, closing
+  the viewers' connections and removing the socket.  Returns ERR
+  where there are no Unix domain sockets.
+*/
+int streamcells(const char *path)
 {
-   /* stub that does nothing */
-   if (bf == FALSE)
+#ifdef SDL_CURSES_STREAM
+   STREAM *s = (SP != NULL) ? SP->stream : NULL;
+   struct sockaddr_un addr;
+   WINDOW *win;
+   mode_t mask;
+   int bound;
+
+   if (SP == NULL)
+      return ERR;
+   if (s != NULL) {
+      while (s->viewers != NULL) {
+	 VIEWER *v = s->viewers;
+
+	 s->viewers = v->next;
+	 viewer_free( v );
+      }
+      close( s->fd );
+      unlink( s->path );
+      free( s->cells );
+      bytes_free( &s->frame );
+      bytes_free( &s->message );
+      free( s );
+      SP->stream = NULL;
+   }
+   if (path == NULL)
       return OK;
-   else
-      return ERR; /* not yet implemented */
+   if (strlen( path ) >= sizeof(addr.sun_path))
+      return ERR;
+
+   s = calloc( 1, sizeof(STREAM) + strlen( path ) );
+   if (s == NULL)
+      return ERR;
+   strcpy( s->path, path );
+   s->fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+   if (s->fd < 0) {
+      free( s );
+      return ERR;
+   }
+   memset( &addr, 0, sizeof(addr) );
+   addr.sun_family = AF_UNIX;
+   strcpy( addr.sun_path, path );
+   unlink( path );
+   mask = umask( 077 );
+   bound = bind( s->fd, (struct sockaddr *) &addr, sizeof(addr) );
+   umask( mask );
+   if ((bound != 0) || (listen( s->fd, 4 ) != 0) ||
+       (fcntl( s->fd, F_SETFL, fcntl( s->fd, F_GETFL ) | O_NONBLOCK ) != 0) ||
+       !stream_size( s, LINES, COLS )) {
+      close( s->fd );
+      if (bound == 0)
+	 unlink( path );
+      free( s->cells );
+      free( s );
+      return ERR;
+   }
+#ifdef STREAM_IGNORE_SIGPIPE
+   signal( SIGPIPE, SIG_IGN );
+#endif
+
+   SP->stream = s;
+   for (win = SP->windows; win != NULL; win = win->next)
+      touchwin( win );
+   return OK;
+#else
+   return ERR;
+#endif
 }
@@ -26,6 +26,8 @@ USA
 #define SDL_NCURSES_H_DEFINED
 
 #include <stdarg.h>
+#include <stdio.h>
+#include <wchar.h>
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <SDL_image.h>
@@ -121,23 +123,70 @@ extern "C" {
 /** maps from a colour pair index to a background colour */
 #define BG(n) (color_pairs[( n & (COLOR_PAIRS-1) ) * 2])
 
-/* not going to support all of these */
-#define A_BLINK      (1 << 24)
-#define A_PROTECT    (2 << 24)
-#define A_INVIS      (3 << 24)
-#define A_ALTCHARSET (4 << 24)
-#define A_CHARTEXT   (5 << 24)
-#define A_BOLD       (6 << 24)
-#define A_STANDOUT   (7 << 24)   /*    Best highlighting mode of the terminal. */
-#define A_UNDERLINE  (8 << 24)
-#define A_REVERSE    (9 << 24)
-#define A_DIM        (10 << 24)
+/* not going to support all of these.  Each attribute is a single bit
+   above the character and colour pair bytes so that they can be
+   combined and tested independently. */
+#define A_CHARTEXT   (0x000000FFU)
+#define A_COLOR      (0x0000FF00U)
+#define A_ATTRIBUTES (0xFFFF0000U)
+#define A_STANDOUT   (1U << 16)   /*    Best highlighting mode of the terminal. */
+#define A_UNDERLINE  (1U << 17)
+#define A_REVERSE    (1U << 18)
+#define A_BLINK      (1U << 19)
+#define A_DIM        (1U << 20)
+#define A_BOLD       (1U << 21)
+#define A_ALTCHARSET (1U << 22)
+#define A_INVIS      (1U << 23)
+#define A_PROTECT    (1U << 24)
 
 #define UNDERLINE(n) ((n) & A_UNDERLINE)
 #define REVERSE(n) ((n) & A_REVERSE)
 #define DIM(n) ((n) & A_DIM)
 #define STANDOUT(n) ((n) & A_STANDOUT)
 #define BOLD(n) ((n) & A_BOLD)
+#define ALTCHARSET(n) ((n) & A_ALTCHARSET)
+#define BLINK(n) ((n) & A_BLINK)
+
+/*
+  The alternate character set.  acs_map is a constant table; each
+  entry is either a character carrying A_ALTCHARSET, which is drawn
+  with a line-drawing glyph generated at the current cell size, or a
+  plain ASCII fallback for symbols we do not draw.
+*/
+#define NCURSES_ACS(c)	(acs_map[(unsigned char)(c)])
+
+#define ACS_ULCORNER	NCURSES_ACS('l') /* upper left corner */
+#define ACS_LLCORNER	NCURSES_ACS('m') /* lower left corner */
+#define ACS_URCORNER	NCURSES_ACS('k') /* upper right corner */
+#define ACS_LRCORNER	NCURSES_ACS('j') /* lower right corner */
+#define ACS_LTEE	NCURSES_ACS('t') /* tee pointing right */
+#define ACS_RTEE	NCURSES_ACS('u') /* tee pointing left */
+#define ACS_BTEE	NCURSES_ACS('v') /* tee pointing up */
+#define ACS_TTEE	NCURSES_ACS('w') /* tee pointing down */
+#define ACS_HLINE	NCURSES_ACS('q') /* horizontal line */
+#define ACS_VLINE	NCURSES_ACS('x') /* vertical line */
+#define ACS_PLUS	NCURSES_ACS('n') /* large plus or crossover */
+#define ACS_S1		NCURSES_ACS('o') /* scan line 1 */
+#define ACS_S3		NCURSES_ACS('p') /* scan line 3 */
+#define ACS_S7		NCURSES_ACS('r') /* scan line 7 */
+#define ACS_S9		NCURSES_ACS('s') /* scan line 9 */
+#define ACS_DIAMOND	NCURSES_ACS('`') /* diamond */
+#define ACS_CKBOARD	NCURSES_ACS('a') /* checker board (stipple) */
+#define ACS_DEGREE	NCURSES_ACS('f') /* degree symbol */
+#define ACS_PLMINUS	NCURSES_ACS('g') /* plus/minus */
+#define ACS_BULLET	NCURSES_ACS('~') /* bullet */
+#define ACS_LARROW	NCURSES_ACS(',') /* arrow pointing left */
+#define ACS_RARROW	NCURSES_ACS('+') /* arrow pointing right */
+#define ACS_DARROW	NCURSES_ACS('.') /* arrow pointing down */
+#define ACS_UARROW	NCURSES_ACS('-') /* arrow pointing up */
+#define ACS_BOARD	NCURSES_ACS('h') /* board of squares */
+#define ACS_LANTERN	NCURSES_ACS('i') /* lantern symbol */
+#define ACS_BLOCK	NCURSES_ACS('0') /* solid square block */
+#define ACS_LEQUAL	NCURSES_ACS('y') /* less/equal */
+#define ACS_GEQUAL	NCURSES_ACS('z') /* greater/equal */
+#define ACS_PI		NCURSES_ACS('{') /* Pi */
+#define ACS_NEQUAL	NCURSES_ACS('|') /* not equal */
+#define ACS_STERLING	NCURSES_ACS('}') /* UK pound sign */
 
 #define KEY_DOWN	SDLK_DOWN	/* down-arrow key */
 #define KEY_UP		SDLK_UP		/* up-arrow key */
@@ -161,6 +210,7 @@ extern "C" {
 #define KEY_END		SDLK_END	/* end key */
 #define KEY_IC         SDLK_INSERT
 #define KEY_EIC        SDLK_DELETE
+#define KEY_RESIZE	(KEY_F(64)+1)	/* the window was resized */
 
 #define MAX_INPUT_PENDING (256)
   
@@ -174,31 +224,82 @@ extern "C" {
    {
 	 int x,y, width,height;
 	 int cx,cy;
-	 char *text;
+	 wchar_t *text;		/* one character per cell */
 	 attr_t *attrib;
-	 bool delay;
+	 int delay;		/* ms wgetch waits for input, -1 forever */
 	 bool keypad_on;
+	 bool leaveok;		/* refresh leaves the cursor where it was */
 	 attr_t attributes;
+	 /* row pointers into text and attrib; line insertion and
+	    deletion rotate these rather than moving cells.  They are
+	    NULL for the rows of a compressed window that are not
+	    expanded, see compressrows */
+	 wchar_t **lines;
+	 attr_t **alines;
+	 /* first and last changed column of each row since the last
+	    refresh, _NOCHANGE if the row is untouched */
+	 int *firstch;
+	 int *lastch;
+	 /* rows that may hold A_BLINK cells */
+	 bool *blinkrows;
+	 struct s_Window *next;	/* list of all windows */
+	 void *cells;		/* the arrays, once wresize has moved them
+				   out of the window's own block */
+	 struct s_Backing *backing;	/* pixels of the cells, see backingstore */
+	 struct s_Runs **runs;	/* per row, the runs of a compressed
+				   window, NULL if it is not one */
 
    } WINDOW;
 
+#define _NOCHANGE (-1)
+
+/* a terminal: its windows, surface, font and input; see newterm */
+   typedef struct s_Screen SCREEN;
+
+/* a complex character: a spacing character followed by any
+   non-spacing ones, and its attributes.  Only the spacing character
+   is drawn. */
+#define CCHARW_MAX (5)
+
+   typedef struct
+   {
+	 attr_t attr;
+	 wchar_t chars[ CCHARW_MAX ];
+   } cchar_t;
+
+/* the second cell of a double-width character holds this */
+#define WIDE_FILLER ((wchar_t) 0xFFFF)
+
+/* wget_wch returns this for function keys, OK for characters */
+#define KEY_CODE_YES (0400)
+
 
 /*
  *  globals
  */
-   extern WINDOW *stdscr;
-   extern WINDOW *curscr;
-   extern unsigned short LINES;
-   extern unsigned short COLS;
-   extern bool echo_on;
-   extern bool cbreak_on;
-   extern int pop_index;
-   extern int push_index;
-   extern char inbuffer[MAX_INPUT_PENDING];
-   extern unsigned int screen_width;
-   extern unsigned int screen_height;
-   extern unsigned int display_char_height;
-   extern unsigned int display_char_width;
+
+/* all but acs_map are per thread, and are those of the screen the
+   thread last made current with newterm or set_term */
+#if defined(__GNUC__)
+#define SDL_CURSES_TLS __thread
+#elif defined(_MSC_VER)
+#define SDL_CURSES_TLS __declspec(thread)
+#else
+#define SDL_CURSES_TLS
+#endif
+
+   extern const chtype acs_map[128];
+   extern SDL_CURSES_TLS WINDOW *stdscr;
+   extern SDL_CURSES_TLS WINDOW *curscr;
+   extern SDL_CURSES_TLS unsigned short LINES;
+   extern SDL_CURSES_TLS unsigned short COLS;
+   extern SDL_CURSES_TLS bool echo_on;
+   extern SDL_CURSES_TLS bool cbreak_on;
+   extern SDL_CURSES_TLS int halfdelay_tenths;
+   extern SDL_CURSES_TLS unsigned int screen_width;
+   extern SDL_CURSES_TLS unsigned int screen_height;
+   extern SDL_CURSES_TLS unsigned int display_char_height;
+   extern SDL_CURSES_TLS unsigned int display_char_width;
 
   
    /*
@@ -206,6 +307,48 @@ extern "C" {
      initializing a program.
    */
    WINDOW *initscr(void);
+
+   /*
+     newterm makes a new screen current for the calling thread.  The
+     first one gets the display and keyboard; others draw on their own
+     surface, which term_surface returns, so that several threads can
+     each run a screen.  set_term changes the calling thread's current
+     screen and delscreen frees one.  After useterminal, or when SDL
+     has no display, the first is drawn on the terminal outfd with ANSI
+     sequences instead and reads infd; type is ignored.
+   */
+   SCREEN *newterm(const char *type, FILE *outfd, FILE *infd);
+   SCREEN *set_term(SCREEN *sp);
+   void delscreen(SCREEN *sp);
+   SDL_Surface *term_surface(SCREEN *sp);
+
+   /*
+     usefont, called before initscr or newterm, has it draw with a TrueType or
+     .fon font at ptsize points rather than the built-in bitmap font.
+     A font that will not open leaves the built-in one in use.
+   */
+   int usefont(const char *path, int ptsize);
+
+   /*
+     atlasthreads, called before initscr or newterm, sets how many threads build
+     the glyphs of a usefont font that are not cached yet: 0 (the
+     default) for one per processor, 1 for none besides the caller.
+   */
+   int atlasthreads(int n);
+
+   /*
+     usescale, called before initscr or newterm, shows every pixel of the grid as
+     a factor x factor block (1 to 4), for large displays.
+   */
+   int usescale(int factor);
+
+   /*
+     useterminal(TRUE), called before initscr or newterm, has it draw on
+     the terminal rather than with SDL.  The windows work as they do
+     with SDL; each refresh sends only the cells that changed, in one
+     write.  Custom colours, backing stores and scr_png need SDL.
+   */
+   int useterminal(bool bf);
   
    /*
      A program should always call endwin before exiting or escaping from
@@ -218,6 +361,15 @@ extern "C" {
 
    int endwin(void);
 
+   /*
+     resizeterm resizes the screen, and stdscr with it, to lines by
+     columns.  wgetch calls it when the user resizes the window and
+     returns KEY_RESIZE.  wresize resizes a window, keeping the contents
+     of the part common to the old and new sizes.
+   */
+   int resizeterm(int lines, int columns);
+   int wresize(WINDOW *win, int lines, int columns);
+
 /*
   The getyx macro places the current cursor position of the given
   window in the two integer variables y and x.
@@ -238,6 +390,7 @@ extern "C" {
 */
 
    int touchwin(WINDOW *win);
+   int touchline(WINDOW *win, int start, int count);
 
 /*
   Calling newwin creates and returns a pointer to a new window with
@@ -257,6 +410,13 @@ extern "C" {
 */
    int delwin(WINDOW *win);
 
+/*
+  windowstats gives the number of live windows of the current screen
+  and the bytes its window pool holds, for debugging.  Windows come
+  from the pool, which reuses the blocks of deleted ones.
+*/
+   int windowstats(int *live, unsigned long *pool_bytes);
+
 /*
   A program should always call endwin before exiting or escaping
   from curses mode temporarily.  This routine restores tty modes,
@@ -287,6 +447,21 @@ extern "C" {
    int refresh(void);
    int wrefresh(WINDOW *win);
 
+/*
+  The qw routines may be called from any thread to queue addstr,
+  attribute, move and chgat calls for a window of screen sp.  The
+  next wrefresh in the thread that owns sp applies them in the order
+  they were queued.  A window must not be deleted while commands for
+  it may still be on their way.
+*/
+   int qwaddstr(SCREEN *sp, WINDOW *win, const char *str);
+   int qwaddnstr(SCREEN *sp, WINDOW *win, const char *str, int n);
+   int qwattron(SCREEN *sp, WINDOW *win, int attrs);
+   int qwattroff(SCREEN *sp, WINDOW *win, int attrs);
+   int qwattrset(SCREEN *sp, WINDOW *win, int attrs);
+   int qwmove(SCREEN *sp, WINDOW *win, int y, int x);
+   int qwchgat(SCREEN *sp, WINDOW *win, int n, attr_t attr, short color);
+
 /*
   These routines move the cursor associated with the window to line y
   and column x.  This routine does not move the physical cursor of the
@@ -313,6 +488,58 @@ extern "C" {
    int mvgetch(int y, int x);
    int mvwgetch(WINDOW *win, int y, int x);
 
+/*
+  The get_wch and wget_wch routines read a character like wgetch, but
+  store it in *wch and return OK for a character or KEY_CODE_YES for a
+  function key, so that characters above 255 cannot be mistaken for
+  key codes.
+*/
+   int get_wch(wint_t *wch);
+   int wget_wch(WINDOW *win, wint_t *wch);
+   int mvget_wch(int y, int x, wint_t *wch);
+   int mvwget_wch(WINDOW *win, int y, int x, wint_t *wch);
+
+/*
+  The ungetch routine places ch back onto the input queue to be
+  returned by the next call to wgetch.  The flushinp routine throws
+  away any typeahead that has been typed by the user and has not yet
+  been read by the program.
+*/
+   int ungetch(int ch);
+   int flushinp(void);
+
+/*
+  The typeahead routine turns typeahead checking on (fd >= 0) or off
+  (fd == -1, the default).  While it is on, refreshes are postponed
+  whenever keys are waiting to be read.
+*/
+   int typeahead(int fd);
+
+/*
+  keyrepeat sets the delay before a held key starts repeating and the
+  interval between repeats, in milliseconds (a delay of 0 turns repeat
+  off).  keycoalesce(TRUE) folds runs of queued repeats of a key into
+  one and drops repeats of keys that have since been released, so a
+  program that falls behind does not replay stale keys;
+  keyrepeats_dropped counts the repeats thrown away.
+*/
+   int keyrepeat(int delay, int interval);
+   int keycoalesce(bool bf);
+   unsigned long keyrepeats_dropped(void);
+
+/*
+  The getstr, wgetstr, getnstr and wgetnstr routines read a whole
+  line, up to a newline, into str.  The user's erase character is
+  interpreted and the line is echoed if echo is on.  The routines
+  with n read at most n characters.
+*/
+   int getstr(char *str);
+   int getnstr(char *str, int n);
+   int wgetstr(WINDOW *win, char *str);
+   int wgetnstr(WINDOW *win, char *str, int n);
+   int mvgetnstr(int y, int x, char *str, int n);
+   int mvwgetnstr(WINDOW *win, int y, int x, char *str, int n);
+
 /*
   The addch, waddch, mvaddch and mvwaddch routines put the character
   ch into the given window at its current window position, which is
@@ -323,6 +550,14 @@ extern "C" {
    int waddch(WINDOW *win, chtype ch);
    int mvaddch(int y, int x, chtype ch);
    int mvwaddch(WINDOW *win, int y, int x, chtype ch);
+
+/*
+  The echochar and wechochar routines are equivalent to addch or waddch
+  followed by refresh or wrefresh, except that only the cell written is
+  drawn, so the cost does not depend on the size of the window.
+*/
+   int echochar(const chtype ch);
+   int wechochar(WINDOW *win, const chtype ch);
 /*
   These  routines write the characters of the (null-terminated) character
   string str on the given window.  It is similar to calling  waddch  once
@@ -340,6 +575,119 @@ extern "C" {
    int mvwaddstr(WINDOW *win, int y, int x, const char *str);
    int mvwaddnstr(WINDOW *win, int y, int x, const char *str, int n);
 
+/*
+  The narrow string routines take their strings as UTF-8; bytes that
+  do not form a valid sequence are taken as Latin-1.
+
+  setcchar initialises a cchar_t from a wide string and attributes.
+  The add_wch family puts a complex character into the window and
+  advances the cursor, by two columns for a double-width character.
+  The addwstr family writes a wide string, the routines with n writing
+  at most n characters.
+*/
+   int setcchar(cchar_t *wcval, const wchar_t *wch, attr_t attrs,
+		short color_pair, void *opts);
+   int add_wch(const cchar_t *wch);
+   int wadd_wch(WINDOW *win, const cchar_t *wch);
+   int mvadd_wch(int y, int x, const cchar_t *wch);
+   int mvwadd_wch(WINDOW *win, int y, int x, const cchar_t *wch);
+   int addwstr(const wchar_t *wstr);
+   int addnwstr(const wchar_t *wstr, int n);
+   int waddwstr(WINDOW *win, const wchar_t *wstr);
+   int waddnwstr(WINDOW *win, const wchar_t *wstr, int n);
+   int mvaddwstr(int y, int x, const wchar_t *wstr);
+   int mvaddnwstr(int y, int x, const wchar_t *wstr, int n);
+   int mvwaddwstr(WINDOW *win, int y, int x, const wchar_t *wstr);
+   int mvwaddnwstr(WINDOW *win, int y, int x, const wchar_t *wstr, int n);
+
+
+/*
+  These routines insert the character ch before the character under the
+  cursor.  All characters to the right of the cursor are moved one space
+  to the right, with the possibility of the rightmost character on the
+  line being lost.  The cursor position does not change.
+*/
+   int insch(chtype ch);
+   int winsch(WINDOW *win, chtype ch);
+   int mvinsch(int y, int x, chtype ch);
+   int mvwinsch(WINDOW *win, int y, int x, chtype ch);
+
+/*
+  These routines delete the character under the cursor; all characters
+  to the right of the cursor on the same line are moved to the left one
+  position and the last character on the line is filled with a blank.
+  The cursor position does not change.
+*/
+   int delch(void);
+   int wdelch(WINDOW *win);
+   int mvdelch(int y, int x);
+   int mvwdelch(WINDOW *win, int y, int x);
+
+/*
+  These routines insert a character string (as many characters as will
+  fit on the line) before the character under the cursor.  All
+  characters to the right of the cursor are shifted right, with the
+  possibility of the rightmost characters on the line being lost.  The
+  cursor position does not change.  The four routines with n as the
+  last argument insert at most n characters; if n is -1 the whole
+  string is inserted.
+*/
+   int insstr(const char *str);
+   int insnstr(const char *str, int n);
+   int winsstr(WINDOW *win, const char *str);
+   int winsnstr(WINDOW *win, const char *str, int n);
+   int mvinsstr(int y, int x, const char *str);
+   int mvwinsstr(WINDOW *win, int y, int x, const char *str);
+
+/*
+  The insdelln and winsdelln routines, for positive n, insert n lines
+  into the specified window above the current line.  The n bottom
+  lines are lost.  For negative n, delete n lines (starting with the
+  one under the cursor), and move the remaining lines up.  The bottom n
+  lines are cleared.  The current cursor position remains the same.
+
+  The insertln and winsertln routines insert a blank line above the
+  current line and the bottom line is lost.  The deleteln and wdeleteln
+  routines delete the line under the cursor; all lines below it are
+  moved up one line and the last line is cleared.
+*/
+   int insdelln(int n);
+   int winsdelln(WINDOW *win, int n);
+   int insertln(void);
+   int winsertln(WINDOW *win);
+   int deleteln(void);
+   int wdeleteln(WINDOW *win);
+
+/*
+  The border and wborder routines draw a box around the edges of a
+  window.  The arguments are the left side, right side, top side,
+  bottom side, top left, top right, bottom left and bottom right
+  characters; a 0 argument selects the default ACS line-drawing
+  character.  box(win, verch, horch) is a shorthand for
+  wborder(win, verch, verch, horch, horch, 0, 0, 0, 0).
+*/
+   int border(chtype ls, chtype rs, chtype ts, chtype bs,
+	      chtype tl, chtype tr, chtype bl, chtype br);
+   int wborder(WINDOW *win, chtype ls, chtype rs, chtype ts, chtype bs,
+	       chtype tl, chtype tr, chtype bl, chtype br);
+   int box(WINDOW *win, chtype verch, chtype horch);
+
+/*
+  The hline and whline functions draw a horizontal (left to right)
+  line using ch starting at the current cursor position in the window.
+  The current cursor position is not changed.  The line is at most n
+  characters long, or as many as fit into the window.  The vline and
+  wvline functions draw a vertical (top to bottom) line in the same
+  way.  A 0 ch selects ACS_HLINE or ACS_VLINE.
+*/
+   int hline(chtype ch, int n);
+   int whline(WINDOW *win, chtype ch, int n);
+   int vline(chtype ch, int n);
+   int wvline(WINDOW *win, chtype ch, int n);
+   int mvhline(int y, int x, chtype ch, int n);
+   int mvwhline(WINDOW *win, int y, int x, chtype ch, int n);
+   int mvvline(int y, int x, chtype ch, int n);
+   int mvwvline(WINDOW *win, int y, int x, chtype ch, int n);
 
 /*
   The printw, wprintw, mvprintw and mvwprintw routines are  analogous  to
@@ -370,6 +718,27 @@ extern "C" {
    int noecho(void);
    int nodelay(WINDOW *win, bool bf);
 
+/*
+  The timeout and wtimeout routines set blocking or non-blocking read
+  for a given window.  If delay is negative, blocking read is used
+  (i.e., waits indefinitely for input).  If delay is zero, then
+  non-blocking read is used (i.e., read returns ERR if no input is
+  waiting).  If delay is positive, then read blocks for delay
+  milliseconds, and returns ERR if there is still no input.
+*/
+   void timeout(int delay);
+   void wtimeout(WINDOW *win, int delay);
+
+/*
+  The halfdelay routine is used for half-delay mode, which is similar
+  to cbreak mode in that characters typed by the user are immediately
+  available to the program.  However, after blocking for tenths
+  tenths of seconds, ERR is returned if nothing has been typed.  The
+  value of tenths must be a number between 1 and 255.  Use nocbreak
+  to leave half-delay mode.
+*/
+   int halfdelay(int tenths);
+
    int standend(void);
    int wstandend(WINDOW *win);
    int standout(void);
@@ -390,6 +759,102 @@ extern "C" {
    int wclear(WINDOW *win);
    int clearok(WINDOW *win, bool bf);
 
+/*
+  The curs_set routine sets the cursor state to invisible, normal, or
+  very visible for visibility equal to 0, 1, or 2 respectively.  If
+  the terminal supports the visibility requested, the previous cursor
+  state is returned; otherwise, ERR is returned.
+
+  Normally the cursor is left at the window cursor position after a
+  refresh.  leaveok(win, TRUE) lets refreshes of win leave the cursor
+  wherever it happens to be.
+*/
+   int curs_set(int visibility);
+   int leaveok(WINDOW *win, bool bf);
+
+/*
+  backingstore(win, TRUE) keeps a pixel copy of win's cells, so that
+  refreshing it after it was only moved or uncovered copies pixels
+  instead of drawing glyphs.  backinglimit caps the bytes the backing
+  stores of the current screen take; the least recently shown windows
+  give theirs up first.
+*/
+   int backingstore(WINDOW *win, bool bf);
+   int backinglimit(unsigned long bytes);
+
+/*
+  compressrows(win, TRUE) keeps win's rows as runs of like cells, so
+  that large, mostly blank windows take little memory and their blank
+  stretches are drawn as plain rectangles.  Rows are expanded while
+  they are written and packed again while waiting for a key.  With
+  win NULL it sets whether newwin makes compressed windows.
+*/
+   int compressrows(WINDOW *win, bool bf);
+
+/*
+  recordframes(path) records the cells each refresh draws, colour
+  changes, resizes and keys to a compact stream in path, until
+  recordframes(NULL).  replayframes draws a recording on the current
+  screen, at its recorded pace or flat out, returning the frames
+  drawn; on a screen without the display it times the renderer alone.
+*/
+   int recordframes(const char *path);
+   long replayframes(const char *path, bool realtime);
+
+/*
+  putwin and getwin write a window to a file and make a window from
+  one; scr_dump and scr_restore do the same for curscr.  The format is
+  this library's own.  scr_png writes what the screen shows as a PNG,
+  encoding it on a thread of its own; scr_png(NULL) waits for it.
+*/
+   int putwin(WINDOW *win, FILE *filep);
+   WINDOW *getwin(FILE *filep);
+   int scr_dump(const char *filename);
+   int scr_restore(const char *filename);
+   int scr_png(const char *filename);
+
+/*
+  shmmirror(name) publishes the screen's cells, as its refreshes leave
+  them, in the POSIX shared memory object name, until shmmirror(NULL).
+  The object is a SCREEN_MIRROR followed by capacity MIRROR_CELLs, of
+  which the first lines * cols are the screen row by row.  A reader
+  takes a consistent copy by reading seq with acquire ordering, trying
+  again while it is odd, copying what it wants, and trying again if
+  seq has changed since.  If capacity outgrows what the reader has
+  mapped, the object has grown and must be mapped again.
+*/
+#define MIRROR_VERSION (1)
+
+   typedef struct
+   {
+	 char magic[ 8 ];		/* "SDLcshm" */
+	 Uint32 version;		/* MIRROR_VERSION */
+	 Uint32 size;			/* of this header, where the cells start */
+	 volatile Uint32 seq;		/* odd while the cells are being written */
+	 volatile Uint32 frame;		/* refreshes published */
+	 Uint32 lines, cols;
+	 Uint32 cursor_row, cursor_col;
+	 Uint32 capacity;		/* cells the object has room for */
+   } SCREEN_MIRROR;
+
+   typedef struct
+   {
+	 Uint32 wc;
+	 Uint32 attr;
+   } MIRROR_CELL;
+
+   int shmmirror(const char *name);
+
+/*
+  streamcells(path) serves the cells each refresh draws on the Unix
+  domain socket path until streamcells(NULL), for viewers in other
+  processes to draw; sdl_ncurses_viewer.c is one.  A viewer is sent a
+  keyframe of the screen when it connects, then a message per refresh,
+  packed when that helps.  Sending never blocks: a viewer too far
+  behind loses frames and is sent a keyframe once it has caught up.
+*/
+   int streamcells(const char *path);
+
 
 /*
   To use these routines start_color must  be  called
@@ -447,6 +912,17 @@ extern "C" {
    int attrset(int attrs);
    int wattrset(WINDOW *win, int attrs);
 
+/*
+  The chgat routines change the attributes of n characters from the
+  cursor (the rest of the line if n is -1) to attr and colour pair
+  color, without moving the cursor.  opts should be NULL.
+*/
+   int chgat(int n, attr_t attr, short color, const void *opts);
+   int wchgat(WINDOW *win, int n, attr_t attr, short color, const void *opts);
+   int mvchgat(int y, int x, int n, attr_t attr, short color, const void *opts);
+   int mvwchgat(WINDOW *win, int y, int x, int n, attr_t attr, short color,
+		const void *opts);
+
 /*
   The routine color_set sets the current color of the given window to the
   foreground/background combination described by  the  color_pair_number.
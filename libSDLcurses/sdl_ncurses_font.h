@@ -0,0 +1,589 @@
+/*
+
+libSDLCurses - a curses compatible API that writes to an SDL
+framebuffer
+
+Copyright (C) 2006 John Connors
+
+This library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation; either version 2.1 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+USA
+*/
+
+/*
+  The built-in font: the 9x16 face of ASCII.fon, in code page 437
+  order.  Each glyph is BUILTIN_FONT_HEIGHT rows of one Uint16, the
+  leftmost pixel in the top bit.  builtin_font_unicode gives the
+  character each glyph shows.
+*/
+
+#ifndef SDL_NCURSES_FONT_H_DEFINED
+#define SDL_NCURSES_FONT_H_DEFINED
+
+#define BUILTIN_FONT_WIDTH  (9)
+#define BUILTIN_FONT_HEIGHT (16)
+
+static const Uint16 builtin_font[ 256 ][ BUILTIN_FONT_HEIGHT ] =
+{
+   /* 0x00 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x01 */ { 0x0000, 0x0000, 0x7E00, 0x8100, 0xA500, 0x8100, 0x8100, 0xBD00,
+		  0x9900, 0x8100, 0x8100, 0x7E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x02 */ { 0x0000, 0x0000, 0x7E00, 0xFF00, 0xDB00, 0xFF00, 0xFF00, 0xC300,
+		  0xE700, 0xFF00, 0xFF00, 0x7E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x03 */ { 0x0000, 0x0000, 0x0000, 0x3600, 0x7F00, 0x7F00, 0x7F00, 0x7F00,
+		  0x3E00, 0x1C00, 0x0800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x04 */ { 0x0000, 0x0000, 0x0000, 0x0800, 0x1C00, 0x3E00, 0x7F00, 0x3E00,
+		  0x1C00, 0x0800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x05 */ { 0x0000, 0x0000, 0x1800, 0x3C00, 0x3C00, 0xE700, 0xE700, 0xE700,
+		  0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x06 */ { 0x0000, 0x0000, 0x1800, 0x3C00, 0x7E00, 0xFF00, 0xFF00, 0x7E00,
+		  0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x07 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x1800, 0x3C00, 0x3C00,
+		  0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x08 */ { 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xE700, 0xC300,
+		  0xC300, 0xE700, 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xFF00 },
+   /* 0x09 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3C00, 0x6600, 0x4200,
+		  0x4200, 0x6600, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x0A */ { 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xC300, 0x9900, 0xBD00,
+		  0xBD00, 0x9900, 0xC300, 0xFF00, 0xFF00, 0xFF00, 0xFF00, 0xFF00 },
+   /* 0x0B */ { 0x0000, 0x0000, 0x0F00, 0x0700, 0x0D00, 0x1900, 0x3C00, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x0C */ { 0x0000, 0x0000, 0x3C00, 0x6600, 0x6600, 0x6600, 0x6600, 0x3C00,
+		  0x1800, 0x7E00, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x0D */ { 0x0000, 0x0000, 0x3F00, 0x3300, 0x3F00, 0x3000, 0x3000, 0x3000,
+		  0x3000, 0x7000, 0xF000, 0xE000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x0E */ { 0x0000, 0x0000, 0x7F00, 0x6300, 0x7F00, 0x6300, 0x6300, 0x6300,
+		  0x6700, 0xE700, 0xE600, 0xC000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x0F */ { 0x0000, 0x0000, 0x1800, 0x1800, 0xDB00, 0x3C00, 0xE700, 0x3C00,
+		  0xDB00, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x10 */ { 0x0000, 0x8000, 0xC000, 0xE000, 0xF000, 0xF800, 0xFE00, 0xF800,
+		  0xF000, 0xE000, 0xC000, 0x8000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x11 */ { 0x0000, 0x0200, 0x0600, 0x0E00, 0x1E00, 0x3E00, 0xFE00, 0x3E00,
+		  0x1E00, 0x0E00, 0x0600, 0x0200, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x12 */ { 0x0000, 0x0000, 0x1800, 0x3C00, 0x7E00, 0x1800, 0x1800, 0x1800,
+		  0x7E00, 0x3C00, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x13 */ { 0x0000, 0x0000, 0x6600, 0x6600, 0x6600, 0x6600, 0x6600, 0x6600,
+		  0x6600, 0x0000, 0x6600, 0x6600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x14 */ { 0x0000, 0x0000, 0x7F00, 0xDB00, 0xDB00, 0xDB00, 0x7B00, 0x1B00,
+		  0x1B00, 0x1B00, 0x1B00, 0x1B00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x15 */ { 0x0000, 0x7C00, 0xC600, 0x6000, 0x3800, 0x6C00, 0xC600, 0xC600,
+		  0x6C00, 0x3800, 0x0C00, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000 },
+   /* 0x16 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0xFE00, 0xFE00, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x17 */ { 0x0000, 0x0000, 0x1800, 0x3C00, 0x7E00, 0x1800, 0x1800, 0x1800,
+		  0x7E00, 0x3C00, 0x1800, 0x7E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x18 */ { 0x0000, 0x0000, 0x1800, 0x3C00, 0x7E00, 0x1800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x19 */ { 0x0000, 0x0000, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800,
+		  0x1800, 0x7E00, 0x3C00, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x1A */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0800, 0x0C00, 0xFE00,
+		  0x0C00, 0x0800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x1B */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x6000, 0xFE00,
+		  0x6000, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x1C */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC000, 0xC000,
+		  0xC000, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x1D */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x2800, 0x6C00, 0xFE00, 0x6C00,
+		  0x2800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x1E */ { 0x0000, 0x0000, 0x0000, 0x1000, 0x3800, 0x3800, 0x7C00, 0x7C00,
+		  0xFE00, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x1F */ { 0x0000, 0x0000, 0x0000, 0xFE00, 0xFE00, 0x7C00, 0x7C00, 0x3800,
+		  0x3800, 0x1000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x20 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x21 */ { 0x0000, 0x0000, 0x1800, 0x3C00, 0x3C00, 0x3C00, 0x3C00, 0x1800,
+		  0x1800, 0x0000, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x22 */ { 0x0000, 0x6600, 0x6600, 0x6600, 0x2400, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x23 */ { 0x0000, 0x0000, 0x0000, 0x6600, 0x6600, 0xFF00, 0x6600, 0x6600,
+		  0x6600, 0xFF00, 0x6600, 0x6600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x24 */ { 0x1800, 0x1800, 0x7C00, 0xC600, 0xC200, 0xC000, 0x7C00, 0x0600,
+		  0x0600, 0x8600, 0xC600, 0x7C00, 0x1800, 0x1800, 0x0000, 0x0000 },
+   /* 0x25 */ { 0x0000, 0x0000, 0x0000, 0xC100, 0xC300, 0x0600, 0x0C00, 0x1800,
+		  0x3000, 0x6000, 0xC300, 0x8300, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x26 */ { 0x0000, 0x0000, 0x3800, 0x6C00, 0x6C00, 0x3800, 0x7600, 0xDC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x27 */ { 0x0000, 0x3000, 0x3000, 0x3000, 0x6000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x28 */ { 0x0000, 0x0000, 0x0C00, 0x1800, 0x3000, 0x3000, 0x3000, 0x3000,
+		  0x3000, 0x3000, 0x1800, 0x0C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x29 */ { 0x0000, 0x0000, 0x3000, 0x1800, 0x0C00, 0x0C00, 0x0C00, 0x0C00,
+		  0x0C00, 0x0C00, 0x1800, 0x3000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x2A */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6600, 0x3C00, 0xFF00,
+		  0x3C00, 0x6600, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x2B */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x1800, 0x1800, 0x7E00,
+		  0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x2C */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x1800, 0x1800, 0x1800, 0x3000, 0x0000, 0x0000, 0x0000 },
+   /* 0x2D */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x2E */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x2F */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0200, 0x0600, 0x0C00, 0x1800,
+		  0x3000, 0x6000, 0xC000, 0x8000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x30 */ { 0x0000, 0x0000, 0x3800, 0x6C00, 0xC600, 0xC600, 0xD600, 0xD600,
+		  0xC600, 0xC600, 0x6C00, 0x3800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x31 */ { 0x0000, 0x0000, 0x1800, 0x3800, 0x7800, 0x1800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x7E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x32 */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0x0600, 0x0C00, 0x1800, 0x3000,
+		  0x6000, 0xC000, 0xC600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x33 */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0x0600, 0x0600, 0x1C00, 0x0600,
+		  0x0600, 0x0600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x34 */ { 0x0000, 0x0000, 0x0C00, 0x1C00, 0x3C00, 0x6C00, 0xCC00, 0xFE00,
+		  0x0C00, 0x0C00, 0x0C00, 0x1E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x35 */ { 0x0000, 0x0000, 0xFE00, 0xC000, 0xC000, 0xC000, 0xFC00, 0x0600,
+		  0x0600, 0x0600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x36 */ { 0x0000, 0x0000, 0x3C00, 0x6000, 0xC000, 0xC000, 0xFC00, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x37 */ { 0x0000, 0x0000, 0xFE00, 0xC600, 0x0600, 0x0C00, 0x1800, 0x3000,
+		  0x3000, 0x3000, 0x3000, 0x3000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x38 */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600, 0xC600, 0x7C00, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x39 */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600, 0xC600, 0x7E00, 0x0600,
+		  0x0600, 0x0600, 0x0C00, 0x7800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x3A */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x1800, 0x1800, 0x0000, 0x0000,
+		  0x0000, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x3B */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x1800, 0x1800, 0x0000, 0x0000,
+		  0x0000, 0x1800, 0x1800, 0x3000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x3C */ { 0x0000, 0x0000, 0x0000, 0x0600, 0x0C00, 0x1800, 0x3000, 0x6000,
+		  0x3000, 0x1800, 0x0C00, 0x0600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x3D */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7E00, 0x0000, 0x0000,
+		  0x7E00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x3E */ { 0x0000, 0x0000, 0x0000, 0x6000, 0x3000, 0x1800, 0x0C00, 0x0600,
+		  0x0C00, 0x1800, 0x3000, 0x6000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x3F */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600, 0x0600, 0x0C00, 0x1800,
+		  0x1800, 0x0000, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x40 */ { 0x0000, 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600, 0xDE00, 0xDE00,
+		  0xDE00, 0xDC00, 0xC000, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x41 */ { 0x0000, 0x0000, 0x1000, 0x3800, 0x6C00, 0xC600, 0xC600, 0xFE00,
+		  0xC600, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x42 */ { 0x0000, 0x0000, 0xFC00, 0x6600, 0x6600, 0x6600, 0x7C00, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0xFC00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x43 */ { 0x0000, 0x0000, 0x3C00, 0x6600, 0xC200, 0xC000, 0xC000, 0xC000,
+		  0xC000, 0xC200, 0x6600, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x44 */ { 0x0000, 0x0000, 0xF800, 0x6C00, 0x6600, 0x6600, 0x6600, 0x6600,
+		  0x6600, 0x6600, 0x6C00, 0xF800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x45 */ { 0x0000, 0x0000, 0xFE00, 0x6600, 0x6200, 0x6800, 0x7800, 0x6800,
+		  0x6000, 0x6200, 0x6600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x46 */ { 0x0000, 0x0000, 0xFE00, 0x6600, 0x6200, 0x6800, 0x7800, 0x6800,
+		  0x6000, 0x6000, 0x6000, 0xF000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x47 */ { 0x0000, 0x0000, 0x3C00, 0x6600, 0xC200, 0xC000, 0xC000, 0xDE00,
+		  0xC600, 0xC600, 0x6600, 0x3A00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x48 */ { 0x0000, 0x0000, 0xC600, 0xC600, 0xC600, 0xC600, 0xFE00, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x49 */ { 0x0000, 0x0000, 0x3C00, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x4A */ { 0x0000, 0x0000, 0x1E00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x4B */ { 0x0000, 0x0000, 0xE600, 0x6600, 0x6600, 0x6C00, 0x7800, 0x7800,
+		  0x6C00, 0x6600, 0x6600, 0xE600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x4C */ { 0x0000, 0x0000, 0xF000, 0x6000, 0x6000, 0x6000, 0x6000, 0x6000,
+		  0x6000, 0x6200, 0x6600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x4D */ { 0x0000, 0x0000, 0xC600, 0xEE00, 0xFE00, 0xFE00, 0xD600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x4E */ { 0x0000, 0x0000, 0xC600, 0xE600, 0xF600, 0xFE00, 0xDE00, 0xCE00,
+		  0xC600, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x4F */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x50 */ { 0x0000, 0x0000, 0xFC00, 0x6600, 0x6600, 0x6600, 0x7C00, 0x6000,
+		  0x6000, 0x6000, 0x6000, 0xF000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x51 */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xD600, 0x7C00, 0x0C00, 0x0E00, 0x0000, 0x0000 },
+   /* 0x52 */ { 0x0000, 0x0000, 0xFC00, 0x6600, 0x6600, 0x6600, 0x7C00, 0x6C00,
+		  0x6600, 0x6600, 0x6600, 0xE600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x53 */ { 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600, 0x6000, 0x3800, 0x0C00,
+		  0x0600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x54 */ { 0x0000, 0x0000, 0x7E00, 0x7E00, 0x5A00, 0x1800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x55 */ { 0x0000, 0x0000, 0xC600, 0xC600, 0xC600, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x56 */ { 0x0000, 0x0000, 0xC600, 0xC600, 0xC600, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0x6C00, 0x3800, 0x1000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x57 */ { 0x0000, 0x0000, 0xC600, 0xC600, 0xC600, 0xC600, 0xD600, 0xD600,
+		  0xD600, 0xFE00, 0xEE00, 0x6C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x58 */ { 0x0000, 0x0000, 0xC600, 0xC600, 0x6C00, 0x7C00, 0x3800, 0x3800,
+		  0x7C00, 0x6C00, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x59 */ { 0x0000, 0x0000, 0x6600, 0x6600, 0x6600, 0x6600, 0x3C00, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x5A */ { 0x0000, 0x0000, 0xFE00, 0xC600, 0x8600, 0x0C00, 0x1800, 0x3000,
+		  0x6000, 0xC200, 0xC600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x5B */ { 0x0000, 0x0000, 0x3C00, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000,
+		  0x3000, 0x3000, 0x3000, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x5C */ { 0x0000, 0x0000, 0x0000, 0x8000, 0xC000, 0xE000, 0x7000, 0x3800,
+		  0x1C00, 0x0E00, 0x0600, 0x0200, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x5D */ { 0x0000, 0x0000, 0x3C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00,
+		  0x0C00, 0x0C00, 0x0C00, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x5E */ { 0x1000, 0x3800, 0x6C00, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x5F */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF00, 0x0000, 0x0000 },
+   /* 0x60 */ { 0x0000, 0x3000, 0x3000, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x61 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7800, 0x0C00, 0x7C00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x62 */ { 0x0000, 0x0000, 0xE000, 0x6000, 0x6000, 0x7800, 0x6C00, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0xDC00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x63 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7C00, 0xC600, 0xC000,
+		  0xC000, 0xC000, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x64 */ { 0x0000, 0x0000, 0x1C00, 0x0C00, 0x0C00, 0x3C00, 0x6C00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x65 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7C00, 0xC600, 0xFE00,
+		  0xC000, 0xC000, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x66 */ { 0x0000, 0x0000, 0x1C00, 0x3600, 0x3200, 0x3000, 0x7800, 0x3000,
+		  0x3000, 0x3000, 0x3000, 0x7800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x67 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7600, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7C00, 0x0C00, 0xCC00, 0x7800, 0x0000 },
+   /* 0x68 */ { 0x0000, 0x0000, 0xE000, 0x6000, 0x6000, 0x6C00, 0x7600, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0xE600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x69 */ { 0x0000, 0x0000, 0x1800, 0x1800, 0x0000, 0x3800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x6A */ { 0x0000, 0x0000, 0x0600, 0x0600, 0x0000, 0x0E00, 0x0600, 0x0600,
+		  0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x6600, 0x3C00, 0x0000 },
+   /* 0x6B */ { 0x0000, 0x0000, 0xE000, 0x6000, 0x6000, 0x6600, 0x6C00, 0x7800,
+		  0x7800, 0x6C00, 0x6600, 0xE600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x6C */ { 0x0000, 0x0000, 0x3800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x6D */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xE600, 0xFF00, 0xDB00,
+		  0xDB00, 0xDB00, 0xDB00, 0xDB00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x6E */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xDC00, 0x6600, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0x6600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x6F */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x70 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xDC00, 0x6600, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0x7C00, 0x6000, 0x6000, 0xF000, 0x0000 },
+   /* 0x71 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7600, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7C00, 0x0C00, 0x0C00, 0x1E00, 0x0000 },
+   /* 0x72 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xDC00, 0x7600, 0x6000,
+		  0x6000, 0x6000, 0x6000, 0xF000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x73 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7C00, 0xC600, 0xC000,
+		  0x7C00, 0x0600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x74 */ { 0x0000, 0x0000, 0x1000, 0x3000, 0x3000, 0xFC00, 0x3000, 0x3000,
+		  0x3000, 0x3000, 0x3600, 0x1C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x75 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCC00, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x76 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0x6C00, 0x3800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x77 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC300, 0xC300, 0xC300,
+		  0xDB00, 0xDB00, 0xFF00, 0x6600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x78 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC300, 0x6600, 0x3C00,
+		  0x1800, 0x3C00, 0x6600, 0xC300, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x79 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7E00, 0x0600, 0x0C00, 0xF800, 0x0000 },
+   /* 0x7A */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00, 0xCC00, 0x1800,
+		  0x3000, 0x6000, 0xC600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x7B */ { 0x0000, 0x0000, 0x0E00, 0x1800, 0x1800, 0x1800, 0x7000, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x0E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x7C */ { 0x0000, 0x0000, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x0000,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000 },
+   /* 0x7D */ { 0x0000, 0x0000, 0x7000, 0x1800, 0x1800, 0x1800, 0x0E00, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x7000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x7E */ { 0x0000, 0x7600, 0xDC00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x7F */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x1000, 0x3800, 0x6C00, 0xC600,
+		  0xC600, 0xC600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x80 */ { 0x0000, 0x0000, 0x3C00, 0x6600, 0xC200, 0xC000, 0xC000, 0xC000,
+		  0xC000, 0xC200, 0x6600, 0x3C00, 0x0C00, 0x0600, 0x7C00, 0x0000 },
+   /* 0x81 */ { 0x0000, 0x0000, 0x0000, 0xCC00, 0x0000, 0xCC00, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x82 */ { 0x0000, 0x0C00, 0x1800, 0x3000, 0x0000, 0x7C00, 0xC600, 0xFE00,
+		  0xC000, 0xC000, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x83 */ { 0x0000, 0x1000, 0x3800, 0x6C00, 0x0000, 0x7800, 0x0C00, 0x7C00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x84 */ { 0x0000, 0x0000, 0x0000, 0xCC00, 0x0000, 0x7800, 0x0C00, 0x7C00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x85 */ { 0x0000, 0x6000, 0x3000, 0x1800, 0x0000, 0x7800, 0x0C00, 0x7C00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x86 */ { 0x0000, 0x3800, 0x6C00, 0x3800, 0x0000, 0x7800, 0x0C00, 0x7C00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x87 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x3C00, 0x6600, 0x6000, 0x6000,
+		  0x6600, 0x3C00, 0x0C00, 0x0600, 0x3C00, 0x0000, 0x0000, 0x0000 },
+   /* 0x88 */ { 0x0000, 0x1000, 0x3800, 0x6C00, 0x0000, 0x7C00, 0xC600, 0xFE00,
+		  0xC000, 0xC000, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x89 */ { 0x0000, 0x0000, 0xC600, 0x0000, 0x0000, 0x7C00, 0xC600, 0xFE00,
+		  0xC000, 0xC000, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x8A */ { 0x0000, 0x6000, 0x3000, 0x1800, 0x0000, 0x7C00, 0xC600, 0xFE00,
+		  0xC000, 0xC000, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x8B */ { 0x0000, 0x0000, 0x6600, 0x0000, 0x0000, 0x3800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x8C */ { 0x0000, 0x1800, 0x3C00, 0x6600, 0x0000, 0x3800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x8D */ { 0x0000, 0x6000, 0x3000, 0x1800, 0x0000, 0x3800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x8E */ { 0x0000, 0xC600, 0x0000, 0x1000, 0x3800, 0x6C00, 0xC600, 0xC600,
+		  0xFE00, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x8F */ { 0x3800, 0x6C00, 0x3800, 0x0000, 0x3800, 0x6C00, 0xC600, 0xC600,
+		  0xFE00, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x90 */ { 0x1800, 0x3000, 0x6000, 0x0000, 0xFE00, 0x6600, 0x6000, 0x7C00,
+		  0x6000, 0x6000, 0x6600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x91 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xDE00, 0x7B00, 0x3B00,
+		  0x7E00, 0xD800, 0xDC00, 0x7700, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x92 */ { 0x0000, 0x0000, 0x0000, 0x3E00, 0x6C00, 0xCC00, 0xCC00, 0xFE00,
+		  0xCC00, 0xCC00, 0xCC00, 0xCE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x93 */ { 0x0000, 0x1000, 0x3800, 0x6C00, 0x0000, 0x7C00, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x94 */ { 0x0000, 0x0000, 0xC600, 0x0000, 0x0000, 0x7C00, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x95 */ { 0x0000, 0x6000, 0x3000, 0x1800, 0x0000, 0x7C00, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x96 */ { 0x0000, 0x3000, 0x7800, 0xCC00, 0x0000, 0xCC00, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x97 */ { 0x0000, 0x6000, 0x3000, 0x1800, 0x0000, 0xCC00, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x98 */ { 0x0000, 0x0000, 0xC600, 0x0000, 0x0000, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7E00, 0x0600, 0x0C00, 0x7800, 0x0000 },
+   /* 0x99 */ { 0x0000, 0xC600, 0x0000, 0x7C00, 0xC600, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x9A */ { 0x0000, 0xC600, 0x0000, 0xC600, 0xC600, 0xC600, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x9B */ { 0x0000, 0x0000, 0x1800, 0x1800, 0x7C00, 0xC600, 0xC000, 0xC000,
+		  0xC000, 0xC600, 0x7C00, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000 },
+   /* 0x9C */ { 0x0000, 0x3800, 0x6C00, 0x6400, 0x6000, 0xF000, 0x6000, 0x6000,
+		  0x6000, 0x6000, 0xE600, 0xFC00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x9D */ { 0x0000, 0x0000, 0xC300, 0x6600, 0x3C00, 0x1800, 0xFF00, 0x1800,
+		  0xFF00, 0x1800, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x9E */ { 0x0000, 0xFC00, 0x6600, 0x6600, 0x7C00, 0x6200, 0x6600, 0x6F00,
+		  0x6600, 0x6600, 0x6600, 0xF300, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0x9F */ { 0x0000, 0x0E00, 0x1B00, 0x1800, 0x1800, 0x1800, 0x7E00, 0x1800,
+		  0x1800, 0x1800, 0xD800, 0x7000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA0 */ { 0x0000, 0x1800, 0x3000, 0x6000, 0x0000, 0x7800, 0x0C00, 0x7C00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA1 */ { 0x0000, 0x0C00, 0x1800, 0x3000, 0x0000, 0x3800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA2 */ { 0x0000, 0x1800, 0x3000, 0x6000, 0x0000, 0x7C00, 0xC600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA3 */ { 0x0000, 0x1800, 0x3000, 0x6000, 0x0000, 0xCC00, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA4 */ { 0x0000, 0x0000, 0x7600, 0xDC00, 0x0000, 0xDC00, 0xE600, 0xC600,
+		  0xC600, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA5 */ { 0x7600, 0xDC00, 0x0000, 0xC600, 0xE600, 0xF600, 0xDE00, 0xCE00,
+		  0xC600, 0xC600, 0xC600, 0xC600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA6 */ { 0x0000, 0x0000, 0x3C00, 0x6C00, 0x6C00, 0x3E00, 0x0000, 0x7E00,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA7 */ { 0x0000, 0x0000, 0x3800, 0x6C00, 0x6C00, 0x3800, 0x0000, 0x7C00,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA8 */ { 0x0000, 0x3000, 0x3000, 0x0000, 0x3000, 0x3000, 0x3000, 0x6000,
+		  0xC000, 0xC600, 0xC600, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xA9 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00, 0xC000,
+		  0xC000, 0xC000, 0xC000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xAA */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00, 0x0600,
+		  0x0600, 0x0600, 0x0600, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xAB */ { 0x0000, 0x6000, 0xE000, 0x6200, 0x6600, 0x6C00, 0x1800, 0x3000,
+		  0x6000, 0xDC00, 0x8600, 0x0C00, 0x1800, 0x3E00, 0x0000, 0x0000 },
+   /* 0xAC */ { 0x0000, 0x6000, 0xE000, 0x6200, 0x6600, 0x6C00, 0x1800, 0x3000,
+		  0x6600, 0xCE00, 0x9A00, 0x3F00, 0x0600, 0x0600, 0x0000, 0x0000 },
+   /* 0xAD */ { 0x0000, 0x0000, 0x1800, 0x1800, 0x0000, 0x1800, 0x1800, 0x3C00,
+		  0x3C00, 0x3C00, 0x3C00, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xAE */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3600, 0x6C00, 0xD800,
+		  0x6C00, 0x3600, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xAF */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xD800, 0x6C00, 0x3600,
+		  0x6C00, 0xD800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xB0 */ { 0x1100, 0x4400, 0x1100, 0x4400, 0x1100, 0x4400, 0x1100, 0x4400,
+		  0x1100, 0x4400, 0x1100, 0x4400, 0x1100, 0x4400, 0x1100, 0x4400 },
+   /* 0xB1 */ { 0x5500, 0xAA00, 0x5500, 0xAA00, 0x5500, 0xAA00, 0x5500, 0xAA00,
+		  0x5500, 0xAA00, 0x5500, 0xAA00, 0x5500, 0xAA00, 0x5500, 0xAA00 },
+   /* 0xB2 */ { 0xDD00, 0x7700, 0xDD00, 0x7700, 0xDD00, 0x7700, 0xDD00, 0x7700,
+		  0xDD00, 0x7700, 0xDD00, 0x7700, 0xDD00, 0x7700, 0xDD00, 0x7700 },
+   /* 0xB3 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xB4 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xF800,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xB5 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xF800, 0x1800,
+		  0xF800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xB6 */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xF600,
+		  0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xB7 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00,
+		  0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xB8 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xF800, 0x1800,
+		  0xF800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xB9 */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xF600, 0x0600,
+		  0xF600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xBA */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600,
+		  0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xBB */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00, 0x0600,
+		  0xF600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xBC */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xF600, 0x0600,
+		  0xFE00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xBD */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xFE00,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xBE */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xF800, 0x1800,
+		  0xF800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xBF */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xF800,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xC0 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1F80,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xC1 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xFF80,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xC2 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF80,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xC3 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1F80,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xC4 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF80,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xC5 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xFF80,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xC6 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1F80, 0x1800,
+		  0x1F80, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xC7 */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3780,
+		  0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xC8 */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3780, 0x3000,
+		  0x3F80, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xC9 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3F80, 0x3000,
+		  0x3780, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xCA */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xF780, 0x0000,
+		  0xFF80, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xCB */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF80, 0x0000,
+		  0xF780, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xCC */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3780, 0x3000,
+		  0x3780, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xCD */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF80, 0x0000,
+		  0xFF80, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xCE */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xF780, 0x0000,
+		  0xF780, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xCF */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xFF80, 0x0000,
+		  0xFF80, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xD0 */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xFF80,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xD1 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF80, 0x0000,
+		  0xFF80, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xD2 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF80,
+		  0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xD3 */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3F80,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xD4 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1F80, 0x1800,
+		  0x1F80, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xD5 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x1F80, 0x1800,
+		  0x1F80, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xD6 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3F80,
+		  0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xD7 */ { 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0xFF80,
+		  0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600, 0x3600 },
+   /* 0xD8 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xFF80, 0x1800,
+		  0xFF80, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xD9 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0xF800,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xDA */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x1F80,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xDB */ { 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80,
+		  0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80 },
+   /* 0xDC */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80 },
+   /* 0xDD */ { 0xF000, 0xF000, 0xF000, 0xF000, 0xF000, 0xF000, 0xF000, 0xF000,
+		  0xF000, 0xF000, 0xF000, 0xF000, 0xF000, 0xF000, 0xF000, 0xF000 },
+   /* 0xDE */ { 0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80,
+		  0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80, 0x0F80 },
+   /* 0xDF */ { 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80, 0xFF80,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE0 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7600, 0xDC00, 0xD800,
+		  0xD800, 0xD800, 0xDC00, 0x7600, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE1 */ { 0x0000, 0x0000, 0x7800, 0xCC00, 0xCC00, 0xCC00, 0xD800, 0xCC00,
+		  0xC600, 0xC600, 0xC600, 0xCC00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE2 */ { 0x0000, 0x0000, 0xFE00, 0xC600, 0xC600, 0xC000, 0xC000, 0xC000,
+		  0xC000, 0xC000, 0xC000, 0xC000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE3 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00, 0x6C00, 0x6C00, 0x6C00,
+		  0x6C00, 0x6C00, 0x6C00, 0x6C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE4 */ { 0x0000, 0x0000, 0x0000, 0xFE00, 0xE600, 0x7000, 0x3800, 0x1C00,
+		  0x3800, 0x7000, 0xE600, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE5 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7E00, 0xD800, 0xD800,
+		  0xD800, 0xD800, 0xD800, 0x7000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE6 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6600, 0x6600, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0x7C00, 0x6000, 0x6000, 0xC000, 0x0000 },
+   /* 0xE7 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x7600, 0xDC00, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE8 */ { 0x0000, 0x0000, 0x0000, 0x7E00, 0x1800, 0x3C00, 0x6600, 0x6600,
+		  0x6600, 0x3C00, 0x1800, 0x7E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xE9 */ { 0x0000, 0x0000, 0x0000, 0x3800, 0x6C00, 0xC600, 0xC600, 0xFE00,
+		  0xC600, 0xC600, 0x6C00, 0x3800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xEA */ { 0x0000, 0x0000, 0x3800, 0x6C00, 0xC600, 0xC600, 0xC600, 0x6C00,
+		  0x6C00, 0x6C00, 0x6C00, 0xEE00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xEB */ { 0x0000, 0x0000, 0x3E00, 0x6000, 0x3000, 0x1800, 0x3C00, 0x6600,
+		  0x6600, 0x6600, 0x6600, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xEC */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7C00, 0xD600, 0xD600,
+		  0x7C00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xED */ { 0x0000, 0x0000, 0x0000, 0x0600, 0x0C00, 0x7C00, 0xDE00, 0xD600,
+		  0xE600, 0x7C00, 0x6000, 0xC000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xEE */ { 0x0000, 0x0000, 0x1800, 0x3000, 0x6000, 0x6000, 0x7800, 0x6000,
+		  0x6000, 0x6000, 0x3000, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xEF */ { 0x0000, 0x0000, 0x7800, 0xCC00, 0xCC00, 0xCC00, 0xCC00, 0xCC00,
+		  0xCC00, 0xCC00, 0xCC00, 0xCC00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF0 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0xFE00, 0x0000, 0x0000, 0xFE00,
+		  0x0000, 0x0000, 0xFE00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF1 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x1800, 0x1800, 0x7E00, 0x1800,
+		  0x1800, 0x0000, 0x0000, 0x7E00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF2 */ { 0x0000, 0x0000, 0x0000, 0x6000, 0x3000, 0x1800, 0x0C00, 0x1800,
+		  0x3000, 0x6000, 0x0000, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF3 */ { 0x0000, 0x0000, 0x0000, 0x0C00, 0x1800, 0x3000, 0x6000, 0x3000,
+		  0x1800, 0x0C00, 0x0000, 0x7C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF4 */ { 0x0000, 0x0000, 0x0E00, 0x1B00, 0x1B00, 0x1B00, 0x1800, 0x1800,
+		  0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800 },
+   /* 0xF5 */ { 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800, 0x1800,
+		  0xD800, 0xD800, 0xD800, 0x7000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF6 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x1800, 0x1800, 0x0000, 0x7E00,
+		  0x0000, 0x1800, 0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF7 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x7600, 0xDC00, 0x0000,
+		  0x7600, 0xDC00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF8 */ { 0x0000, 0x3800, 0x6C00, 0x6C00, 0x3800, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xF9 */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x1800,
+		  0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xFA */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x1800, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xFB */ { 0x0000, 0x0F00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0xEC00,
+		  0x6C00, 0x6C00, 0x3C00, 0x1C00, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xFC */ { 0x0000, 0xD800, 0x6C00, 0x6C00, 0x6C00, 0x6C00, 0x6C00, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xFD */ { 0x0000, 0x7000, 0xD800, 0x3000, 0x6000, 0xC800, 0xF800, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xFE */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x7E00, 0x7E00, 0x7E00, 0x7E00,
+		  0x7E00, 0x7E00, 0x7E00, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 },
+   /* 0xFF */ { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 }
+};
+
+static const Uint16 builtin_font_unicode[ 256 ] =
+{
+   0x0000, 0x263A, 0x263B, 0x2665, 0x2666, 0x2663, 0x2660, 0x2022,
+   0x25D8, 0x25CB, 0x25D9, 0x2642, 0x2640, 0x266A, 0x266B, 0x263C,
+   0x25BA, 0x25C4, 0x2195, 0x203C, 0x00B6, 0x00A7, 0x25AC, 0x21A8,
+   0x2191, 0x2193, 0x2192, 0x2190, 0x221F, 0x2194, 0x25B2, 0x25BC,
+   0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027,
+   0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+   0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+   0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+   0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+   0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+   0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+   0x0058, 0x0059, 0x005A, 0x005B, 0x005C, 0x005D, 0x005E, 0x005F,
+   0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+   0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+   0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+   0x0078, 0x0079, 0x007A, 0x007B, 0x007C, 0x007D, 0x007E, 0x2302,
+   0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,
+   0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+   0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,
+   0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192,
+   0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,
+   0x00BF, 0x2310, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+   0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,
+   0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,
+   0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F,
+   0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,
+   0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B,
+   0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,
+   0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4,
+   0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229,
+   0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248,
+   0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0
+};
+
+#endif /* SDL_NCURSES_FONT_H_DEFINED */
@@ -0,0 +1,295 @@
+/*
+
+sdl_ncurses_viewer - shows the screen a libSDLcurses program serves
+with streamcells
+Copyright (C) 2006 John Connors
+
+This library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation; either version 2.1 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+USA
+
+*/
+
+/*
+  usage: sdl_ncurses_viewer socket
+
+  Connects to the socket a program passed to streamcells and draws the
+  cells it is sent on a screen of its own, with libSDLcurses, until
+  the program stops serving them or q is pressed.  The messages are
+  described with streamcells in sdl_ncurses.c.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "sdl_ncurses.h"
+
+#define STREAM_PACKED (0x80)
+
+typedef struct
+{
+      const Uint8 *p, *end;
+} READER;
+
+static Uint8 *input = NULL;		/* received, not yet taken as messages */
+static size_t input_used = 0, input_size = 0;
+static Uint8 *unpacked = NULL;
+static size_t unpacked_size = 0;
+
+static int get_varint(READER *r, unsigned long *v)
+{
+   unsigned int shift = 0;
+   int c;
+
+   *v = 0;
+   do {
+      if ((r->p >= r->end) || (shift >= sizeof(unsigned long) * 8))
+	 return 0;
+      c = *r->p++;
+      *v |= (unsigned long) (c & 0x7f) << shift;
+      shift += 7;
+   } while (c & 0x80);
+   return 1;
+}
+
+/* undo the LZ packing of a payload into unpacked; 0 if it is bad */
+static int unpack(READER *r)
+{
+   unsigned long n;
+   size_t out = 0, len, distance;
+   int tag;
+
+   if (!get_varint( r, &n ))
+      return 0;
+   if (n > unpacked_size) {
+      free( unpacked );
+      unpacked = malloc( n );
+      unpacked_size = (unpacked != NULL) ? n : 0;
+      if (unpacked == NULL)
+	 return 0;
+   }
+   while (r->p < r->end) {
+      tag = *r->p++;
+      if (tag < 0x80) {
+	 len = tag + 1;
+	 if ((len > (size_t) (r->end - r->p)) || (len > n - out))
+	    return 0;
+	 memcpy( unpacked + out, r->p, len );
+	 r->p += len;
+	 out += len;
+      } else {
+	 len = (tag & 0x7f) + 3;
+	 if (r->end - r->p < 2)
+	    return 0;
+	 distance = r->p[0] | (r->p[1] << 8);
+	 r->p += 2;
+	 if ((distance == 0) || (distance > out) || (len > n - out))
+	    return 0;
+	 /* byte by byte, as the copy may overlap what it makes */
+	 for (; len > 0; len--, out++)
+	    unpacked[out] = unpacked[out - distance];
+      }
+   }
+   if (out != n)
+      return 0;
+   r->p = unpacked;
+   r->end = unpacked + n;
+   return 1;
+}
+
+/* draw n cells from runs, starting at row y, column x, going on to the
+ * next row at the end of one */
+static int draw_runs(READER *r, int y, int x, unsigned long n, int cols)
+{
+   unsigned long len, wc, attr;
+   wchar_t s[ 2 ];
+   cchar_t cc;
+
+   while (n > 0) {
+      if (!get_varint( r, &len ) || !get_varint( r, &wc ) || !get_varint( r, &attr ) ||
+	  (len == 0) || (len > n))
+	 return 0;
+      n -= len;
+      s[0] = (wchar_t) wc;
+      s[1] = L'\0';
+      setcchar( &cc, s, (attr_t) attr & A_ATTRIBUTES, PAIR_NUMBER( attr ), NULL );
+      for (; len > 0; len--) {
+	 if (s[0] != WIDE_FILLER)
+	    mvwadd_wch( stdscr, y, x, &cc );
+	 if (++x == cols) {
+	    x = 0;
+	    y++;
+	 }
+      }
+   }
+   return 1;
+}
+
+static int palette(READER *r)
+{
+   unsigned long f, b;
+   int i, c[ 3 ];
+
+   if (r->end - r->p < COLORS * 3)
+      return 0;
+   for (i = 0; i < COLORS; i++) {
+      c[0] = *r->p++;
+      c[1] = *r->p++;
+      c[2] = *r->p++;
+      /* the smallest values init_color takes back to these */
+      init_color( i, (c[0] * 1000 + 254) / 255, (c[1] * 1000 + 254) / 255,
+		  (c[2] * 1000 + 254) / 255 );
+   }
+   for (i = 0; i < COLOR_PAIRS; i++) {
+      if (!get_varint( r, &f ) || !get_varint( r, &b ))
+	 return 0;
+      if (i > 0)
+	 init_pair( i, (short) f, (short) b );
+   }
+   return 1;
+}
+
+static int keyframe(READER *r)
+{
+   unsigned long lines, cols;
+
+   if (!get_varint( r, &lines ) || !get_varint( r, &cols ) ||
+       (lines == 0) || (cols == 0) || (lines > 0x7fff) || (cols > 0x7fff))
+      return 0;
+   if ((lines != LINES) || (cols != COLS))
+      resizeterm( lines, cols );
+   return draw_runs( r, 0, 0, lines * cols, cols );
+}
+
+static int frame(READER *r, int cols)
+{
+   unsigned long row, col, n;
+
+   for (;;) {
+      if (!get_varint( r, &row ))
+	 return 0;
+      if (row == 0)
+	 return 1;
+      if (!get_varint( r, &col ) || !get_varint( r, &n ) ||
+	  !draw_runs( r, row - 1, col, n, cols ))
+	 return 0;
+   }
+}
+
+/* act on a message; 0 if it is bad */
+static int message(const Uint8 *data, size_t n)
+{
+   READER r;
+   int type = data[0];
+
+   r.p = data + 1;
+   r.end = data + n;
+   if ((type & STREAM_PACKED) && !unpack( &r ))
+      return 0;
+   switch (type & ~STREAM_PACKED) {
+   case 'H':
+      return 1;
+   case 'C':
+      return palette( &r );
+   case 'K':
+      return keyframe( &r );
+   case 'F':
+      /* spans reach as far as the server's screen is wide, which is
+       * no wider than the last keyframe made this one */
+      return frame( &r, COLS );
+   }
+   return 1;			/* from a later version */
+}
+
+/* take what has been received as messages, returning how many */
+static int take_messages(void)
+{
+   size_t at = 0, n;
+   int count = 0;
+
+   while (input_used - at >= 4) {
+      n = ((size_t) input[at] << 24) | (input[at + 1] << 16) | (input[at + 2] << 8) | input[at + 3];
+      if ((n == 0) || (input_used - at - 4 < n))
+	 break;
+      if (!message( input + at + 4, n )) {
+	 fprintf( stderr, "sdl_ncurses_viewer: bad message\n" );
+	 exit( 1 );
+      }
+      at += 4 + n;
+      count++;
+   }
+   memmove( input, input + at, input_used - at );
+   input_used -= at;
+   return count;
+}
+
+int main(int argc, char *argv[])
+{
+   struct sockaddr_un addr;
+   ssize_t got;
+   int fd, ch;
+
+   if ((argc != 2) || (strlen( argv[1] ) >= sizeof(addr.sun_path))) {
+      fprintf( stderr, "usage: sdl_ncurses_viewer socket\n" );
+      return 2;
+   }
+   fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+   memset( &addr, 0, sizeof(addr) );
+   addr.sun_family = AF_UNIX;
+   strcpy( addr.sun_path, argv[1] );
+   if ((fd < 0) || (connect( fd, (struct sockaddr *) &addr, sizeof(addr) ) != 0)) {
+      perror( argv[1] );
+      return 1;
+   }
+
+   initscr();
+   start_color();
+   noecho();
+   curs_set( 0 );
+   timeout( 10 );
+   for (;;) {
+      ch = getch();
+      if (ch == 'q')
+	 break;
+      for (;;) {
+	 if (input_size - input_used < 65536) {
+	    input_size = input_used + 65536;
+	    input = realloc( input, input_size );
+	    if (input == NULL)
+	       return 1;
+	 }
+	 got = recv( fd, input + input_used, input_size - input_used, MSG_DONTWAIT );
+	 if (got > 0) {
+	    input_used += got;
+	    continue;
+	 }
+	 if ((got < 0) && (errno == EINTR))
+	    continue;
+	 break;
+      }
+      if (take_messages() > 0)
+	 refresh();
+      if ((got == 0) || ((got < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)))
+	 break;			/* the program has gone */
+   }
+   endwin();
+   close( fd );
+   return 0;
+}